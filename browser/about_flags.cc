@@ -183,7 +183,8 @@ constexpr char kBraveReduceLanguageDescription[] =
 constexpr char kCosmeticFilteringSyncLoadName[] =
     "Enable sync loading of cosmetic filter rules";
 constexpr char kCosmeticFilteringSyncLoadDescription[] =
-    "Enable sync loading of cosmetic filter rules";
+    "Load cosmetic filter rules with a sync IPC from the renderer, instead of "
+    "having the browser push them to the frame as its navigation commits";
 
 constexpr char kBraveIpfsName[] = "Enable IPFS";
 constexpr char kBraveIpfsDescription[] = "Enable native support of IPFS.";
@@ -13,8 +13,11 @@
 
 #include "base/base64.h"
 #include "base/memory/raw_ptr.h"
+#include "base/metrics/histogram_samples.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
+#include "base/test/metrics/histogram_tester.h"
 #include "base/test/scoped_feature_list.h"
 #include "base/test/thread_test_helper.h"
 #include "brave/browser/brave_browser_process.h"
@@ -22,6 +25,7 @@
 #include "brave/components/brave_component_updater/browser/local_data_files_service.h"
 #include "brave/components/brave_shields/browser/ad_block_component_installer.h"
 #include "brave/components/brave_shields/browser/ad_block_custom_filters_provider.h"
+#include "brave/components/brave_shields/browser/ad_block_decision_cache.h"
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_service_manager.h"
@@ -52,6 +56,7 @@
 #include "net/dns/mock_host_resolver.h"
 #include "net/test/test_data_directory.h"
 #include "services/network/host_resolver.h"
+#include "testing/perf/perf_result_reporter.h"
 
 #if BUILDFLAG(ENABLE_PLAYLIST)
 #include "brave/browser/playlist/playlist_service_factory.h"
@@ -93,6 +98,7 @@ using brave_shields::features::kBraveAdblockCosmeticFiltering;
 using brave_shields::features::kBraveAdblockCosmeticFilteringChildFrames;
 using brave_shields::features::kBraveAdblockDefault1pBlocking;
 using brave_shields::features::kCosmeticFilteringJsPerformance;
+using brave_shields::features::kCosmeticFilteringSyncLoad;
 
 AdBlockServiceTest::AdBlockServiceTest()
     : ws_server_(net::SpawnedTestServer::TYPE_WS,
@@ -331,6 +337,10 @@ void AdBlockServiceTest::WaitForAdBlockServiceThreads() {
   ASSERT_TRUE(tr_helper->Run());
 }
 
+brave_shields::AdBlockDecisionCache* AdBlockServiceTest::decision_cache() {
+  return g_brave_browser_process->ad_block_service()->decision_cache_.get();
+}
+
 void AdBlockServiceTest::ShieldsDown(const GURL& url) {
   brave_shields::SetBraveShieldsEnabled(content_settings(), false, url);
 }
@@ -1442,6 +1452,79 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, CollapseBlockedIframe) {
                          "i[0].clientHeight === 0"));
 }
 
+class DecisionCacheFlagEnabledTest : public AdBlockServiceTest {
+ public:
+  DecisionCacheFlagEnabledTest() {
+    feature_list_.InitAndEnableFeature(kBraveAdblockDecisionCache);
+  }
+
+ private:
+  base::test::ScopedFeatureList feature_list_;
+};
+
+// Load the same blocked image on two navigations, and make sure the second
+// request is answered from the decision cache.
+IN_PROC_BROWSER_TEST_F(DecisionCacheFlagEnabledTest,
+                       RepeatedRequestIsServedFromCache) {
+  UpdateAdBlockInstanceWithRules("ad_banner.png");
+  ASSERT_TRUE(decision_cache());
+
+  GURL url = embedded_test_server()->GetURL(kAdBlockTestPage);
+  ASSERT_TRUE(ui_test_utils::NavigateToURL(browser(), url));
+  content::WebContents* contents =
+      browser()->tab_strip_model()->GetActiveWebContents();
+  ASSERT_EQ(true, EvalJs(contents,
+                         "setExpectations(0, 1, 0, 0);"
+                         "addImage('ad_banner.png')"));
+  WaitForAdBlockServiceThreads();
+  const size_t first_hit_count = decision_cache()->decision_hit_count();
+
+  ASSERT_TRUE(ui_test_utils::NavigateToURL(browser(), url));
+  ASSERT_EQ(true, EvalJs(contents,
+                         "setExpectations(0, 1, 0, 0);"
+                         "addImage('ad_banner.png')"));
+  WaitForAdBlockServiceThreads();
+  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 2ULL);
+
+  // At least the page itself and the image were answered from the cache.
+  const size_t hit_count = decision_cache()->decision_hit_count();
+  EXPECT_GE(hit_count, first_hit_count + 2);
+
+  perf_test::PerfResultReporter reporter("AdBlockDecisionCache", "blocking");
+  reporter.RegisterImportantMetric(".hits", "count");
+  reporter.RegisterImportantMetric(".misses", "count");
+  reporter.RegisterImportantMetric(".saved_time_per_hit", "us");
+  reporter.RegisterImportantMetric(".csp_hits", "count");
+  reporter.RegisterImportantMetric(".csp_misses", "count");
+  reporter.AddResult(".hits", hit_count);
+  reporter.AddResult(".misses", decision_cache()->decision_miss_count());
+  reporter.AddResult(".csp_hits", decision_cache()->csp_hit_count());
+  reporter.AddResult(".csp_misses", decision_cache()->csp_miss_count());
+  reporter.AddResult(
+      ".saved_time_per_hit",
+      decision_cache()->saved_match_time().InMicrosecondsF() / hit_count);
+}
+
+// Make sure that changing the rules drops the cached decisions.
+IN_PROC_BROWSER_TEST_F(DecisionCacheFlagEnabledTest, RuleChangeInvalidates) {
+  UpdateAdBlockInstanceWithRules("ad_banner.png");
+
+  GURL url = embedded_test_server()->GetURL(kAdBlockTestPage);
+  ASSERT_TRUE(ui_test_utils::NavigateToURL(browser(), url));
+  content::WebContents* contents =
+      browser()->tab_strip_model()->GetActiveWebContents();
+  ASSERT_EQ(true, EvalJs(contents,
+                         "setExpectations(0, 1, 0, 0);"
+                         "addImage('ad_banner.png')"));
+
+  UpdateAdBlockInstanceWithRules("");
+  ASSERT_TRUE(ui_test_utils::NavigateToURL(browser(), url));
+  ASSERT_EQ(true, EvalJs(contents,
+                         "setExpectations(1, 0, 0, 0);"
+                         "addImage('ad_banner.png')"));
+  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+}
+
 class CollapseBlockedElementsFlagDisabledTest : public AdBlockServiceTest {
  public:
   CollapseBlockedElementsFlagDisabledTest() {
@@ -1996,6 +2079,115 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, CosmeticFilteringSimple) {
   EXPECT_EQ(base::Value(true), result_third.value);
 }
 
+// Waits until the elements matching `selector` have `expected` as the computed
+// value of `property`.
+void WaitForSelectorStyle(content::WebContents* contents,
+                          const std::string& selector,
+                          const std::string& property,
+                          const std::string& expected) {
+  const char kTemplate[] = R"(
+      async function waitCSSSelector() {
+        if (await checkSelector($1, $2, $3)) {
+          window.domAutomationController.send(true);
+        } else {
+          console.log('still waiting for css selector', $1);
+          setTimeout(waitCSSSelector, 200);
+        }
+      } waitCSSSelector())";
+
+  ASSERT_TRUE(EvalJs(contents,
+                     content::JsReplace(kTemplate, selector, property,
+                                        expected),
+                     content::EXECUTE_SCRIPT_USE_MANUAL_REPLY)
+                  .ExtractBool());
+}
+
+// Loads a page with cosmetic filters a few times, and reports how long the
+// renderer main thread was held up getting its initial cosmetic resources on
+// each navigation.
+void ReportProcessURLTime(Browser* browser, const std::string& metric) {
+  constexpr int kNavigationCount = 10;
+  base::HistogramTester histogram_tester;
+  for (int i = 0; i < kNavigationCount; i++) {
+    const GURL tab_url = browser->tab_strip_model()
+                             ->GetActiveWebContents()
+                             ->GetLastCommittedURL()
+                             .Resolve("?" + base::NumberToString(i));
+    ASSERT_TRUE(ui_test_utils::NavigateToURL(browser, tab_url));
+  }
+
+  content::FetchHistogramsFromChildProcesses();
+  std::unique_ptr<base::HistogramSamples> samples =
+      histogram_tester.GetHistogramSamplesSinceCreation(
+          "Brave.CosmeticFilters.ProcessURL");
+  ASSERT_GE(samples->TotalCount(), kNavigationCount);
+
+  perf_test::PerfResultReporter reporter("CosmeticFilters", "ProcessURL");
+  reporter.RegisterImportantMetric(metric, "us");
+  reporter.AddResult(metric, static_cast<double>(samples->sum()) /
+                                 samples->TotalCount());
+}
+
+class CosmeticFilteringSyncLoadFlagEnabledTest : public AdBlockServiceTest {
+ public:
+  CosmeticFilteringSyncLoadFlagEnabledTest() {
+    feature_list_.InitAndEnableFeature(kCosmeticFilteringSyncLoad);
+  }
+
+ private:
+  base::test::ScopedFeatureList feature_list_;
+};
+
+// Rules are applied when the renderer blocks on loading them, and the time
+// spent blocking is reported to compare with resources pushed by the browser.
+IN_PROC_BROWSER_TEST_F(CosmeticFilteringSyncLoadFlagEnabledTest,
+                       CosmeticFilteringSyncLoad) {
+  ASSERT_TRUE(InstallDefaultAdBlockExtension());
+  UpdateAdBlockInstanceWithRules("b.com###ad-banner");
+
+  GURL tab_url =
+      embedded_test_server()->GetURL("b.com", "/cosmetic_filtering.html");
+  ASSERT_TRUE(ui_test_utils::NavigateToURL(browser(), tab_url));
+
+  content::WebContents* contents =
+      browser()->tab_strip_model()->GetActiveWebContents();
+  WaitForSelectorStyle(contents, "#ad-banner", "display", "none");
+
+  ReportProcessURLTime(browser(), ".sync_load");
+}
+
+// Rules pushed by the browser as the navigation commits are applied without
+// the renderer asking for them.
+IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, CosmeticFilteringPushedResources) {
+  ASSERT_TRUE(InstallDefaultAdBlockExtension());
+  UpdateAdBlockInstanceWithRules(
+      "b.com###ad-banner\n"
+      "b.com##.ad:style(padding-bottom: 10px)");
+
+  GURL tab_url =
+      embedded_test_server()->GetURL("b.com", "/cosmetic_filtering.html");
+  ASSERT_TRUE(ui_test_utils::NavigateToURL(browser(), tab_url));
+
+  content::WebContents* contents =
+      browser()->tab_strip_model()->GetActiveWebContents();
+  WaitForSelectorStyle(contents, "#ad-banner", "display", "none");
+  WaitForSelectorStyle(contents, ".ad", "padding-bottom", "10px");
+
+  ReportProcessURLTime(browser(), ".pushed");
+
+  // The about:blank frame of the page above takes its rules from its parent
+  // without a navigation in the browser, so it still asks for them. Frames
+  // which are navigated to shouldn't have to.
+  base::HistogramTester histogram_tester;
+  ASSERT_TRUE(ui_test_utils::NavigateToURL(
+      browser(),
+      embedded_test_server()->GetURL("b.com", "/cosmetic_frame.html")));
+  content::FetchHistogramsFromChildProcesses();
+  histogram_tester.ExpectTotalCount("Brave.CosmeticFilters.ProcessURL", 1);
+  histogram_tester.ExpectTotalCount(
+      "Brave.CosmeticFilters.UrlCosmeticResources", 0);
+}
+
 class CosmeticFilteringChildFramesFlagEnabledTest : public AdBlockServiceTest {
  public:
   CosmeticFilteringChildFramesFlagEnabledTest() {
@@ -18,6 +18,7 @@
 class HostContentSettingsMap;
 
 namespace brave_shields {
+class AdBlockDecisionCache;
 class AdBlockService;
 }  // namespace brave_shields
 
@@ -54,6 +55,7 @@ class AdBlockServiceTest : public extensions::ExtensionBrowserTest {
                                        bool enable_list = true);
   void SetSubscriptionIntervals();
   void WaitForAdBlockServiceThreads();
+  brave_shields::AdBlockDecisionCache* decision_cache();
   void ShieldsDown(const GURL& url);
   void DisableAggressiveMode();
   void LoadDAT(base::FilePath path);
@@ -8,6 +8,7 @@
 #include "base/command_line.h"
 #include "base/feature_list.h"
 #include "brave/browser/brave_ads/ads_tab_helper.h"
+#include "brave/browser/brave_browser_process.h"
 #include "brave/browser/brave_news/brave_news_tab_helper.h"
 #include "brave/browser/brave_rewards/rewards_tab_helper.h"
 #include "brave/browser/brave_shields/brave_shields_web_contents_observer.h"
@@ -20,6 +21,7 @@
 #include "brave/components/brave_perf_predictor/browser/perf_predictor_tab_helper.h"
 #include "brave/components/brave_today/common/features.h"
 #include "brave/components/brave_wayback_machine/buildflags.h"
+#include "brave/components/cosmetic_filters/browser/cosmetic_filters_tab_helper.h"
 #include "brave/components/greaselion/browser/buildflags/buildflags.h"
 #include "brave/components/ipfs/buildflags/buildflags.h"
 #include "brave/components/speedreader/common/buildflags.h"
@@ -78,6 +80,8 @@ void AttachTabHelpers(content::WebContents* web_contents) {
 #endif
   brave_shields::BraveShieldsWebContentsObserver::CreateForWebContents(
       web_contents);
+  cosmetic_filters::CosmeticFiltersTabHelper::MaybeCreateForWebContents(
+      web_contents, g_brave_browser_process->ad_block_service());
 #if BUILDFLAG(IS_ANDROID)
   BackgroundVideoPlaybackTabHelper::CreateForWebContents(web_contents);
 #else
@@ -0,0 +1,206 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/brave_ad_block_cname_cache.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/raw_ptr.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/strings/string_util.h"
+#include "mojo/public/cpp/bindings/receiver.h"
+#include "net/base/net_errors.h"
+#include "net/dns/public/dns_query_type.h"
+
+namespace brave {
+
+namespace {
+
+const std::string& GetCanonicalNameFromAliases(
+    const std::vector<std::string>& dns_aliases) {
+  return dns_aliases.size() >= 1 ? dns_aliases.front() : base::EmptyString();
+}
+
+}  // namespace
+
+// A single host resolution, shared by all of the lookups of its host which
+// are made while it is in flight.
+class AdblockCnameCache::Request : public network::mojom::ResolveHostClient {
+ public:
+  Request(AdblockCnameCache* cache, const Key& key, bool speculative)
+      : cache_(cache),
+        key_(key),
+        speculative_(speculative),
+        start_time_(base::TimeTicks::Now()) {}
+  Request(const Request&) = delete;
+  Request& operator=(const Request&) = delete;
+  ~Request() override = default;
+
+  mojo::PendingRemote<network::mojom::ResolveHostClient> BindNewPipe() {
+    auto remote = receiver_.BindNewPipeAndPassRemote();
+    receiver_.set_disconnect_handler(base::BindOnce(
+        &Request::OnDisconnect, base::Unretained(this)));
+    return remote;
+  }
+
+  void AddCallback(CanonicalNameCallback callback) {
+    callbacks_.push_back(std::move(callback));
+  }
+
+  void RunCallbacks(const absl::optional<std::string>& canonical_name) {
+    for (auto& callback : callbacks_) {
+      std::move(callback).Run(canonical_name);
+    }
+    callbacks_.clear();
+  }
+
+  bool speculative() const { return speculative_; }
+
+  // network::mojom::ResolveHostClient:
+  void OnComplete(int32_t result,
+                  const net::ResolveErrorInfo& resolve_error_info,
+                  const absl::optional<net::AddressList>& resolved_addresses,
+                  const absl::optional<net::HostResolverEndpointResults>&
+                      endpoint_results_with_metadata) override {
+    UMA_HISTOGRAM_TIMES("Brave.ShieldsCNAMEBlocking.TotalResolutionTime",
+                        base::TimeTicks::Now() - start_time_);
+    absl::optional<std::string> canonical_name;
+    if (result == net::OK && resolved_addresses) {
+      DCHECK(!resolved_addresses->empty());
+      canonical_name =
+          GetCanonicalNameFromAliases(resolved_addresses->dns_aliases());
+    }
+    // Deletes `this`.
+    cache_->OnRequestComplete(key_, std::move(canonical_name),
+                              /*cacheable*/ true);
+  }
+
+  // Should not be called
+  void OnTextResults(const std::vector<std::string>& text_results) override {
+    NOTREACHED();
+  }
+
+  // Should not be called
+  void OnHostnameResults(const std::vector<net::HostPortPair>& hosts) override {
+    NOTREACHED();
+  }
+
+ private:
+  void OnDisconnect() {
+    // Deletes `this`.
+    cache_->OnRequestComplete(key_, absl::nullopt, /*cacheable*/ false);
+  }
+
+  const raw_ptr<AdblockCnameCache> cache_;
+  const Key key_;
+  const bool speculative_;
+  const base::TimeTicks start_time_;
+  std::vector<CanonicalNameCallback> callbacks_;
+  mojo::Receiver<network::mojom::ResolveHostClient> receiver_{this};
+};
+
+AdblockCnameCache::AdblockCnameCache(ResolveHostCallback resolve_host,
+                                     bool cache_results)
+    : resolve_host_(std::move(resolve_host)),
+      cache_results_(cache_results),
+      entries_(kMaxEntries) {}
+
+AdblockCnameCache::~AdblockCnameCache() = default;
+
+void AdblockCnameCache::GetCanonicalName(
+    const net::HostPortPair& host,
+    const net::NetworkAnonymizationKey& network_anonymization_key,
+    CanonicalNameCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const Key key(network_anonymization_key, host.host());
+
+  if (const Entry* entry = GetEntry(key)) {
+    cache_hit_count_++;
+    std::move(callback).Run(entry->canonical_name);
+    return;
+  }
+
+  auto it = requests_.find(key);
+  Request* request = it != requests_.end()
+                         ? it->second.get()
+                         : StartRequest(key, host, /*speculative*/ false);
+  request->AddCallback(std::move(callback));
+}
+
+void AdblockCnameCache::Prefetch(
+    const net::HostPortPair& host,
+    const net::NetworkAnonymizationKey& network_anonymization_key,
+    base::OnceCallback<bool()> is_allowed) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const Key key(network_anonymization_key, host.host());
+
+  if (speculative_request_count_ >= kMaxSpeculativeResolutions ||
+      requests_.count(key) || GetEntry(key) || !std::move(is_allowed).Run()) {
+    return;
+  }
+
+  StartRequest(key, host, /*speculative*/ true);
+}
+
+const AdblockCnameCache::Entry* AdblockCnameCache::GetEntry(const Key& key) {
+  auto it = entries_.Get(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  if (it->second.expiration <= base::TimeTicks::Now()) {
+    entries_.Erase(it);
+    return nullptr;
+  }
+  return &it->second;
+}
+
+AdblockCnameCache::Request* AdblockCnameCache::StartRequest(
+    const Key& key,
+    const net::HostPortPair& host,
+    bool speculative) {
+  auto request = std::make_unique<Request>(this, key, speculative);
+  Request* request_ptr = request.get();
+  requests_[key] = std::move(request);
+  resolution_count_++;
+  if (speculative) {
+    speculative_request_count_++;
+  }
+
+  network::mojom::ResolveHostParametersPtr optional_parameters =
+      network::mojom::ResolveHostParameters::New();
+  optional_parameters->include_canonical_name = true;
+  optional_parameters->dns_query_type = net::DnsQueryType::A;
+
+  resolve_host_.Run(host, key.first, std::move(optional_parameters),
+                    request_ptr->BindNewPipe());
+  return request_ptr;
+}
+
+void AdblockCnameCache::OnRequestComplete(
+    const Key& key,
+    absl::optional<std::string> canonical_name,
+    bool cacheable) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = requests_.find(key);
+  DCHECK(it != requests_.end());
+  std::unique_ptr<Request> request = std::move(it->second);
+  requests_.erase(it);
+  if (request->speculative()) {
+    speculative_request_count_--;
+  }
+
+  if (cache_results_ && cacheable) {
+    const base::TimeDelta ttl =
+        canonical_name.has_value() ? kPositiveTtl : kNegativeTtl;
+    entries_.Put(key, Entry{canonical_name, base::TimeTicks::Now() + ttl});
+  }
+
+  // Callbacks may start new lookups, which is safe now that `request` has been
+  // taken out of `requests_`.
+  request->RunCallbacks(canonical_name);
+}
+
+}  // namespace brave
@@ -0,0 +1,115 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_CNAME_CACHE_H_
+#define BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_CNAME_CACHE_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/callback.h"
+#include "base/containers/lru_cache.h"
+#include "base/sequence_checker.h"
+#include "base/supports_user_data.h"
+#include "base/time/time.h"
+#include "mojo/public/cpp/bindings/pending_remote.h"
+#include "net/base/host_port_pair.h"
+#include "net/base/network_anonymization_key.h"
+#include "services/network/public/mojom/host_resolver.mojom.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace brave {
+
+// Resolves the canonical names of hosts for CNAME uncloaking on behalf of one
+// network context.
+//
+// Concurrent lookups of the same host share a single resolution, so a lookup
+// started by `Prefetch` as soon as a request to an allowed host is seen is
+// picked up by the uncloaking check once the request has been matched against
+// the adblock engines, instead of the DNS round trip only starting then. When
+// `cache_results` is set, canonical names are also kept for `kPositiveTtl`,
+// and failed resolutions for `kNegativeTtl`.
+class AdblockCnameCache : public base::SupportsUserData::Data {
+ public:
+  using ResolveHostCallback = base::RepeatingCallback<void(
+      const net::HostPortPair& host,
+      const net::NetworkAnonymizationKey& network_anonymization_key,
+      network::mojom::ResolveHostParametersPtr optional_parameters,
+      mojo::PendingRemote<network::mojom::ResolveHostClient> response_client)>;
+  // Runs with the canonical name of the host, or with `absl::nullopt` if the
+  // host could not be resolved.
+  using CanonicalNameCallback =
+      base::OnceCallback<void(absl::optional<std::string>)>;
+
+  static constexpr base::TimeDelta kPositiveTtl = base::Minutes(1);
+  static constexpr base::TimeDelta kNegativeTtl = base::Seconds(10);
+  static constexpr size_t kMaxEntries = 500;
+  // Bounds the number of speculative resolutions in flight, so that only the
+  // hosts of the first subresources of a page load are resolved ahead of time.
+  static constexpr size_t kMaxSpeculativeResolutions = 16;
+
+  AdblockCnameCache(ResolveHostCallback resolve_host, bool cache_results);
+  AdblockCnameCache(const AdblockCnameCache&) = delete;
+  AdblockCnameCache& operator=(const AdblockCnameCache&) = delete;
+  ~AdblockCnameCache() override;
+
+  // Runs `callback` synchronously if the canonical name of `host` is cached,
+  // otherwise once it has been resolved.
+  void GetCanonicalName(
+      const net::HostPortPair& host,
+      const net::NetworkAnonymizationKey& network_anonymization_key,
+      CanonicalNameCallback callback);
+
+  // Starts resolving `host` unless it is already cached or being resolved, or
+  // `is_allowed` returns false. `is_allowed` is only run when a resolution
+  // would otherwise be started.
+  void Prefetch(const net::HostPortPair& host,
+                const net::NetworkAnonymizationKey& network_anonymization_key,
+                base::OnceCallback<bool()> is_allowed);
+
+  size_t resolution_count() const { return resolution_count_; }
+  size_t cache_hit_count() const { return cache_hit_count_; }
+
+ private:
+  class Request;
+
+  using Key = std::pair<net::NetworkAnonymizationKey, std::string>;
+
+  struct Entry {
+    absl::optional<std::string> canonical_name;
+    base::TimeTicks expiration;
+  };
+
+  // Returns the cached entry for `key` if there is an unexpired one.
+  const Entry* GetEntry(const Key& key);
+  Request* StartRequest(const Key& key,
+                        const net::HostPortPair& host,
+                        bool speculative);
+  // Called by the request for `key` once it completes. `cacheable` is false if
+  // the resolution was interrupted rather than failed.
+  void OnRequestComplete(const Key& key,
+                         absl::optional<std::string> canonical_name,
+                         bool cacheable);
+
+  ResolveHostCallback resolve_host_;
+  const bool cache_results_;
+
+  base::LRUCache<Key, Entry> entries_;
+  std::map<Key, std::unique_ptr<Request>> requests_;
+  size_t speculative_request_count_ = 0;
+
+  size_t resolution_count_ = 0;
+  size_t cache_hit_count_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_CNAME_CACHE_H_
@@ -0,0 +1,267 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/brave_ad_block_cname_cache.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/task_environment.h"
+#include "net/base/schemeful_site.h"
+#include "net/dns/mock_host_resolver.h"
+#include "net/log/net_log.h"
+#include "services/network/host_resolver.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+constexpr char kCloakedHost[] = "cloaked.example.com";
+constexpr char kCanonicalHost[] = "tracker.adnetwork.net";
+constexpr char kMissingHost[] = "missing.example.com";
+
+net::HostPortPair HostPortPairFor(const std::string& host) {
+  return net::HostPortPair(host, 443);
+}
+
+base::OnceCallback<bool()> Allowed() {
+  return base::BindOnce([] { return true; });
+}
+
+net::NetworkAnonymizationKey KeyForSite(const std::string& url) {
+  const net::SchemefulSite site(GURL(url));
+  return net::NetworkAnonymizationKey(site, site);
+}
+
+// Records the canonical names passed to the callbacks it hands out.
+class CanonicalNameRecorder {
+ public:
+  AdblockCnameCache::CanonicalNameCallback Callback() {
+    return base::BindOnce(&CanonicalNameRecorder::OnCanonicalName,
+                          base::Unretained(this));
+  }
+
+  size_t count() const { return results_.size(); }
+  const absl::optional<std::string>& last() const { return results_.back(); }
+
+ private:
+  void OnCanonicalName(absl::optional<std::string> canonical_name) {
+    results_.push_back(std::move(canonical_name));
+  }
+
+  std::vector<absl::optional<std::string>> results_;
+};
+
+}  // namespace
+
+class AdblockCnameCacheTest : public testing::Test {
+ public:
+  AdblockCnameCacheTest() {
+    host_resolver_.rules()->AddIPLiteralRuleWithDnsAliases(
+        kCloakedHost, "127.0.0.1", std::set<std::string>({kCanonicalHost}));
+    host_resolver_.rules()->AddSimulatedFailure(kMissingHost);
+  }
+
+ protected:
+  std::unique_ptr<AdblockCnameCache> CreateCache(bool cache_results) {
+    return std::make_unique<AdblockCnameCache>(
+        base::BindRepeating(&AdblockCnameCacheTest::ResolveHost,
+                            base::Unretained(this)),
+        cache_results);
+  }
+
+  void ResolveHost(
+      const net::HostPortPair& host,
+      const net::NetworkAnonymizationKey& network_anonymization_key,
+      network::mojom::ResolveHostParametersPtr optional_parameters,
+      mojo::PendingRemote<network::mojom::ResolveHostClient> response_client) {
+    EXPECT_TRUE(optional_parameters->include_canonical_name);
+    resolver_wrapper_.ResolveHost(
+        network::mojom::HostResolverHost::NewHostPortPair(host),
+        network_anonymization_key, std::move(optional_parameters),
+        std::move(response_client));
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::MainThreadType::IO,
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  net::MockHostResolver host_resolver_;
+  network::HostResolver resolver_wrapper_{&host_resolver_, net::NetLog::Get()};
+  CanonicalNameRecorder recorder_;
+};
+
+TEST_F(AdblockCnameCacheTest, ResolvesCanonicalName) {
+  auto cache = CreateCache(true);
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  EXPECT_EQ(0u, recorder_.count());
+
+  task_environment_.RunUntilIdle();
+  ASSERT_EQ(1u, recorder_.count());
+  EXPECT_EQ(kCanonicalHost, recorder_.last());
+  EXPECT_EQ(1u, host_resolver_.num_resolve());
+}
+
+TEST_F(AdblockCnameCacheTest, ServesCachedNameUntilExpired) {
+  auto cache = CreateCache(true);
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  task_environment_.RunUntilIdle();
+
+  // Cached names are returned synchronously.
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  ASSERT_EQ(2u, recorder_.count());
+  EXPECT_EQ(kCanonicalHost, recorder_.last());
+  EXPECT_EQ(1u, host_resolver_.num_resolve());
+  EXPECT_EQ(1u, cache->cache_hit_count());
+
+  task_environment_.FastForwardBy(AdblockCnameCache::kPositiveTtl);
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  task_environment_.RunUntilIdle();
+  ASSERT_EQ(3u, recorder_.count());
+  EXPECT_EQ(kCanonicalHost, recorder_.last());
+  EXPECT_EQ(2u, host_resolver_.num_resolve());
+}
+
+TEST_F(AdblockCnameCacheTest, CachesFailuresForShorterTime) {
+  auto cache = CreateCache(true);
+  cache->GetCanonicalName(HostPortPairFor(kMissingHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  task_environment_.RunUntilIdle();
+  ASSERT_EQ(1u, recorder_.count());
+  EXPECT_FALSE(recorder_.last());
+
+  cache->GetCanonicalName(HostPortPairFor(kMissingHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  ASSERT_EQ(2u, recorder_.count());
+  EXPECT_FALSE(recorder_.last());
+  EXPECT_EQ(1u, host_resolver_.num_resolve());
+
+  task_environment_.FastForwardBy(AdblockCnameCache::kNegativeTtl);
+  cache->GetCanonicalName(HostPortPairFor(kMissingHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(3u, recorder_.count());
+  EXPECT_EQ(2u, host_resolver_.num_resolve());
+}
+
+TEST_F(AdblockCnameCacheTest, PartitionsByNetworkAnonymizationKey) {
+  auto cache = CreateCache(true);
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          KeyForSite("https://a.com"), recorder_.Callback());
+  task_environment_.RunUntilIdle();
+
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          KeyForSite("https://b.com"), recorder_.Callback());
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(2u, recorder_.count());
+  EXPECT_EQ(2u, host_resolver_.num_resolve());
+}
+
+TEST_F(AdblockCnameCacheTest, DoesNotCacheWhenDisabled) {
+  auto cache = CreateCache(false);
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  task_environment_.RunUntilIdle();
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  task_environment_.RunUntilIdle();
+
+  EXPECT_EQ(2u, recorder_.count());
+  EXPECT_EQ(2u, host_resolver_.num_resolve());
+}
+
+TEST_F(AdblockCnameCacheTest, SharesConcurrentResolution) {
+  auto cache = CreateCache(false);
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  task_environment_.RunUntilIdle();
+
+  ASSERT_EQ(2u, recorder_.count());
+  EXPECT_EQ(kCanonicalHost, recorder_.last());
+  EXPECT_EQ(1u, host_resolver_.num_resolve());
+}
+
+TEST_F(AdblockCnameCacheTest, LookupJoinsPrefetch) {
+  auto cache = CreateCache(true);
+  cache->Prefetch(HostPortPairFor(kCloakedHost),
+                  net::NetworkAnonymizationKey(), Allowed());
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  task_environment_.RunUntilIdle();
+
+  ASSERT_EQ(1u, recorder_.count());
+  EXPECT_EQ(kCanonicalHost, recorder_.last());
+  EXPECT_EQ(1u, host_resolver_.num_resolve());
+
+  // A completed prefetch is served from the cache.
+  cache->Prefetch(HostPortPairFor(kCloakedHost),
+                  net::NetworkAnonymizationKey(), Allowed());
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  EXPECT_EQ(2u, recorder_.count());
+  EXPECT_EQ(1u, host_resolver_.num_resolve());
+}
+
+TEST_F(AdblockCnameCacheTest, PrefetchSkipsDisallowedHosts) {
+  auto cache = CreateCache(true);
+  cache->Prefetch(HostPortPairFor(kCloakedHost), net::NetworkAnonymizationKey(),
+                  base::BindOnce([] { return false; }));
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(0u, cache->resolution_count());
+
+  // Hosts which are already cached aren't checked again.
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  task_environment_.RunUntilIdle();
+  bool checked = false;
+  cache->Prefetch(HostPortPairFor(kCloakedHost), net::NetworkAnonymizationKey(),
+                  base::BindOnce(
+                      [](bool* checked) {
+                        *checked = true;
+                        return true;
+                      },
+                      &checked));
+  EXPECT_FALSE(checked);
+  EXPECT_EQ(1u, cache->resolution_count());
+}
+
+TEST_F(AdblockCnameCacheTest, BoundsSpeculativeResolutions) {
+  auto cache = CreateCache(true);
+  for (size_t i = 0; i <= AdblockCnameCache::kMaxSpeculativeResolutions; i++) {
+    cache->Prefetch(HostPortPairFor("host" + base::NumberToString(i) + ".com"),
+                    net::NetworkAnonymizationKey(), Allowed());
+  }
+  EXPECT_EQ(AdblockCnameCache::kMaxSpeculativeResolutions,
+            cache->resolution_count());
+
+  // Lookups which are needed right away aren't bounded.
+  cache->GetCanonicalName(HostPortPairFor(kCloakedHost),
+                          net::NetworkAnonymizationKey(), recorder_.Callback());
+  EXPECT_EQ(AdblockCnameCache::kMaxSpeculativeResolutions + 1,
+            cache->resolution_count());
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(1u, recorder_.count());
+
+  // Once the speculative resolutions complete, more can be started.
+  cache->Prefetch(HostPortPairFor("other.com"), net::NetworkAnonymizationKey(),
+                  Allowed());
+  EXPECT_EQ(AdblockCnameCache::kMaxSpeculativeResolutions + 2,
+            cache->resolution_count());
+}
+
+}  // namespace brave
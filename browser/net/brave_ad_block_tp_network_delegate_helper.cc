@@ -15,9 +15,12 @@
 #include "base/metrics/histogram_macros.h"
 #include "base/no_destructor.h"
 #include "base/strings/string_util.h"
+#include "base/task/thread_pool.h"
+#include "base/time/time.h"
 #include "brave/browser/brave_browser_process.h"
 #include "brave/browser/brave_shields/ad_block_pref_service_factory.h"
 #include "brave/browser/brave_shields/brave_shields_web_contents_observer.h"
+#include "brave/browser/net/brave_ad_block_cname_cache.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/components/brave_shields/browser/ad_block_pref_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
@@ -37,7 +40,6 @@
 #include "content/public/common/url_constants.h"
 #include "extensions/common/url_pattern.h"
 #include "mojo/public/cpp/bindings/remote.h"
-#include "net/dns/public/dns_query_type.h"
 #include "services/network/host_resolver.h"
 #include "services/network/network_context.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
@@ -48,10 +50,7 @@ namespace brave {
 
 namespace {
 
-const std::string& GetCanonicalName(
-    const std::vector<std::string>& dns_aliases) {
-  return dns_aliases.size() >= 1 ? dns_aliases.front() : base::EmptyString();
-}
+const char kAdblockCnameCacheUserDataKey[] = "brave_adblock_cname_cache";
 
 }  // namespace
 
@@ -70,116 +69,112 @@ struct EngineFlags {
   bool did_match_important = false;
 };
 
-void UseCnameResult(scoped_refptr<base::SequencedTaskRunner> task_runner,
-                    const ResponseCallback& next_callback,
-                    std::shared_ptr<BraveRequestInfo> ctx,
-                    EngineFlags previous_result,
-                    absl::optional<std::string> cname);
-
-class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
- private:
-  mojo::Receiver<network::mojom::ResolveHostClient> receiver_{this};
-  base::OnceCallback<void(absl::optional<std::string>)> cb_;
-  base::TimeTicks start_time_;
-
- public:
-  AdblockCnameResolveHostClient(
-      const ResponseCallback& next_callback,
-      scoped_refptr<base::SequencedTaskRunner> task_runner,
-      std::shared_ptr<BraveRequestInfo> ctx,
-      EngineFlags previous_result) {
-    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
-    cb_ = base::BindOnce(&UseCnameResult, task_runner, std::move(next_callback),
-                         ctx, previous_result);
-
-    const auto network_anonymization_key = ctx->network_anonymization_key;
-
-    network::mojom::ResolveHostParametersPtr optional_parameters =
-        network::mojom::ResolveHostParameters::New();
-    optional_parameters->include_canonical_name = true;
-    optional_parameters->dns_query_type = net::DnsQueryType::A;
-
-    SecureDnsConfig secure_dns_config =
-        SystemNetworkContextManager::GetStubResolverConfigReader()
-            ->GetSecureDnsConfiguration(false);
-    // Explicitly specify source when DNS over HTTPS is enabled to avoid
-    // using `HostResolverProc` which will be handled by system resolver
-    // See https://crbug.com/872665
-    if (secure_dns_config.mode() == net::SecureDnsMode::kSecure)
-      optional_parameters->source = net::HostResolverSource::DNS;
-
-    start_time_ = base::TimeTicks::Now();
-
-    if (g_testing_host_resolver) {
-      g_testing_host_resolver->ResolveHost(
-          network::mojom::HostResolverHost::NewHostPortPair(
-              net::HostPortPair::FromURL(ctx->request_url)),
-          network_anonymization_key, std::move(optional_parameters),
-          receiver_.BindNewPipeAndPassRemote());
-    } else {
-      auto* web_contents =
-          content::WebContents::FromFrameTreeNodeId(ctx->frame_tree_node_id);
-      if (!web_contents) {
-        start_time_ = base::TimeTicks::Now();
-        this->OnComplete(net::ERR_FAILED, net::ResolveErrorInfo(),
-                         absl::nullopt, absl::nullopt);
-        return;
-      }
-
-      network::mojom::NetworkContext* network_context =
-          web_contents->GetBrowserContext()
-              ->GetDefaultStoragePartition()
-              ->GetNetworkContext();
-
-      network_context->ResolveHost(
-          network::mojom::HostResolverHost::NewHostPortPair(
-              net::HostPortPair::FromURL(ctx->request_url)),
-          network_anonymization_key, std::move(optional_parameters),
-          receiver_.BindNewPipeAndPassRemote());
-    }
+void ResolveHostForBrowserContext(
+    content::BrowserContext* browser_context,
+    const net::HostPortPair& host,
+    const net::NetworkAnonymizationKey& network_anonymization_key,
+    network::mojom::ResolveHostParametersPtr optional_parameters,
+    mojo::PendingRemote<network::mojom::ResolveHostClient> response_client) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
-    receiver_.set_disconnect_handler(base::BindOnce(
-        &AdblockCnameResolveHostClient::OnComplete, base::Unretained(this),
-        net::ERR_NAME_NOT_RESOLVED, net::ResolveErrorInfo(net::ERR_FAILED),
-        absl::nullopt, absl::nullopt));
+  SecureDnsConfig secure_dns_config =
+      SystemNetworkContextManager::GetStubResolverConfigReader()
+          ->GetSecureDnsConfiguration(false);
+  // Explicitly specify source when DNS over HTTPS is enabled to avoid
+  // using `HostResolverProc` which will be handled by system resolver
+  // See https://crbug.com/872665
+  if (secure_dns_config.mode() == net::SecureDnsMode::kSecure)
+    optional_parameters->source = net::HostResolverSource::DNS;
+
+  if (g_testing_host_resolver) {
+    g_testing_host_resolver->ResolveHost(
+        network::mojom::HostResolverHost::NewHostPortPair(host),
+        network_anonymization_key, std::move(optional_parameters),
+        std::move(response_client));
+    return;
   }
 
-  void OnComplete(int32_t result,
-                  const net::ResolveErrorInfo& resolve_error_info,
-                  const absl::optional<net::AddressList>& resolved_addresses,
-                  const absl::optional<net::HostResolverEndpointResults>&
-                      endpoint_results_with_metadata) override {
-    UMA_HISTOGRAM_TIMES("Brave.ShieldsCNAMEBlocking.TotalResolutionTime",
-                        base::TimeTicks::Now() - start_time_);
-    if (result == net::OK && resolved_addresses) {
-      DCHECK(resolved_addresses.has_value() && !resolved_addresses->empty());
-      std::move(cb_).Run(absl::optional<std::string>(
-          GetCanonicalName(resolved_addresses.value().dns_aliases())));
-    } else {
-      std::move(cb_).Run(absl::nullopt);
-    }
+  browser_context->GetDefaultStoragePartition()
+      ->GetNetworkContext()
+      ->ResolveHost(network::mojom::HostResolverHost::NewHostPortPair(host),
+                    network_anonymization_key, std::move(optional_parameters),
+                    std::move(response_client));
+}
 
-    delete this;
-  }
+// Returns the CNAME cache for the default network context of
+// `browser_context`, creating it if needed.
+AdblockCnameCache* GetAdblockCnameCache(
+    content::BrowserContext* browser_context) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  DCHECK(browser_context);
 
-  // Should not be called
-  void OnTextResults(const std::vector<std::string>& text_results) override {
-    NOTREACHED();
+  auto* cname_cache = static_cast<AdblockCnameCache*>(
+      browser_context->GetUserData(kAdblockCnameCacheUserDataKey));
+  if (!cname_cache) {
+    auto new_cname_cache = std::make_unique<AdblockCnameCache>(
+        base::BindRepeating(&ResolveHostForBrowserContext,
+                            base::Unretained(browser_context)),
+        base::FeatureList::IsEnabled(
+            brave_shields::features::kBraveAdblockCnameCache));
+    cname_cache = new_cname_cache.get();
+    browser_context->SetUserData(kAdblockCnameCacheUserDataKey,
+                                 std::move(new_cname_cache));
   }
+  return cname_cache;
+}
 
-  // Should not be called
-  void OnHostnameResults(const std::vector<net::HostPortPair>& hosts) override {
-    NOTREACHED();
-  }
-};
+// Requests which don't belong to a tab aren't uncloaked.
+bool CanResolveCnameForRequest(const BraveRequestInfo& ctx) {
+  return g_testing_host_resolver ||
+         content::WebContents::FromFrameTreeNodeId(ctx.frame_tree_node_id);
+}
+
+void UseCnameResult(const ResponseCallback& next_callback,
+                    std::shared_ptr<BraveRequestInfo> ctx,
+                    EngineFlags previous_result,
+                    absl::optional<std::string> cname);
+
+bool ShouldUseAggressiveBlocking(const BraveRequestInfo& ctx) {
+  return ctx.aggressive_blocking ||
+         SameDomainOrHost(
+             ctx.initiator_url,
+             url::Origin::CreateFromNormalizedTuple("https", "youtube.com", 80),
+             net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+}
+
+// Returns true if the engines don't block requests to the host of the request
+// URL, checked the same way as ShouldStartRequest checks the request itself.
+bool EnginesAllowHost(std::shared_ptr<BraveRequestInfo> ctx) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  EngineFlags result;
+  std::string mock_data_url;
+  std::string rewritten_url;
+  g_brave_browser_process->ad_block_service()
+      ->GetEngineSnapshots()
+      .ShouldStartRequest(ctx->request_url.GetWithEmptyPath(),
+                          ctx->resource_type, ctx->initiator_url.host(),
+                          ShouldUseAggressiveBlocking(*ctx),
+                          &result.did_match_rule, &result.did_match_exception,
+                          &result.did_match_important, &mock_data_url,
+                          &rewritten_url);
+  return !result.did_match_important &&
+         (!result.did_match_rule || result.did_match_exception);
+}
 
 // If `canonical_url` is specified, this will only check if the CNAME-uncloaked
 // response should be blocked. Otherwise, it will run the check for the
 // original request URL.
+// If `snapshots` is specified, the request is matched against them on a
+// thread pool worker. Otherwise, it is matched on the ad block task runner.
 EngineFlags ShouldBlockRequestOnTaskRunner(
     std::shared_ptr<BraveRequestInfo> ctx,
     EngineFlags previous_result,
-    absl::optional<GURL> canonical_url) {
+    absl::optional<GURL> canonical_url,
+    absl::optional<brave_shields::AdBlockService::EngineSnapshots> snapshots,
+    base::TimeTicks post_time) {
+  UMA_HISTOGRAM_TIMES("Brave.Adblock.ShouldBlockRequest.QueueTime",
+                      base::TimeTicks::Now() - post_time);
+
   if (!ctx->initiator_url.is_valid()) {
     return previous_result;
   }
@@ -192,20 +187,24 @@ EngineFlags ShouldBlockRequestOnTaskRunner(
     url_to_check = ctx->request_url;
   }
 
-  bool force_aggressive = SameDomainOrHost(
-      ctx->initiator_url,
-      url::Origin::CreateFromNormalizedTuple("https", "youtube.com", 80),
-      net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  const bool aggressive_blocking = ShouldUseAggressiveBlocking(*ctx);
 
   std::string rewritten_url;
 
   SCOPED_UMA_HISTOGRAM_TIMER("Brave.Adblock.ShouldBlockRequest");
-  g_brave_browser_process->ad_block_service()->ShouldStartRequest(
-      url_to_check, ctx->resource_type, source_host,
-      ctx->aggressive_blocking || force_aggressive,
-      &previous_result.did_match_rule, &previous_result.did_match_exception,
-      &previous_result.did_match_important, &ctx->mock_data_url,
-      &rewritten_url);
+  if (snapshots) {
+    snapshots->ShouldStartRequest(
+        url_to_check, ctx->resource_type, source_host, aggressive_blocking,
+        &previous_result.did_match_rule, &previous_result.did_match_exception,
+        &previous_result.did_match_important, &ctx->mock_data_url,
+        &rewritten_url);
+  } else {
+    g_brave_browser_process->ad_block_service()->ShouldStartRequest(
+        url_to_check, ctx->resource_type, source_host, aggressive_blocking,
+        &previous_result.did_match_rule, &previous_result.did_match_exception,
+        &previous_result.did_match_important, &ctx->mock_data_url,
+        &rewritten_url);
+  }
 
   if (GURL(rewritten_url).is_valid() &&
       (ctx->method == "GET" || ctx->method == "HEAD" ||
@@ -222,27 +221,63 @@ EngineFlags ShouldBlockRequestOnTaskRunner(
   return previous_result;
 }
 
-void OnShouldBlockRequestResult(
-    bool then_check_uncloaked,
-    scoped_refptr<base::SequencedTaskRunner> task_runner,
-    const ResponseCallback& next_callback,
-    std::shared_ptr<BraveRequestInfo> ctx,
-    EngineFlags result) {
+// Matches the request on a thread pool worker against snapshots of the
+// engines when parallel matching is enabled, so that requests don't queue
+// behind each other or behind engine reloads on the ad block task runner.
+void PostShouldBlockRequest(std::shared_ptr<BraveRequestInfo> ctx,
+                            EngineFlags previous_result,
+                            absl::optional<GURL> canonical_url,
+                            base::OnceCallback<void(EngineFlags)> reply) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  auto* ad_block_service = g_brave_browser_process->ad_block_service();
+
+  if (base::FeatureList::IsEnabled(
+          brave_shields::features::kBraveAdblockParallelMatching)) {
+    base::ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE,
+        {base::TaskPriority::USER_BLOCKING,
+         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+        base::BindOnce(&ShouldBlockRequestOnTaskRunner, ctx, previous_result,
+                       std::move(canonical_url),
+                       ad_block_service->GetEngineSnapshots(),
+                       base::TimeTicks::Now()),
+        std::move(reply));
+    return;
+  }
+
+  ad_block_service->GetTaskRunner()->PostTaskAndReplyWithResult(
+      FROM_HERE,
+      base::BindOnce(&ShouldBlockRequestOnTaskRunner, ctx, previous_result,
+                     std::move(canonical_url), absl::nullopt,
+                     base::TimeTicks::Now()),
+      std::move(reply));
+}
+
+void OnShouldBlockRequestResult(bool then_check_uncloaked,
+                                const ResponseCallback& next_callback,
+                                std::shared_ptr<BraveRequestInfo> ctx,
+                                EngineFlags result) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
   if (ctx->blocked_by == kAdBlocked) {
     brave_shields::BraveShieldsWebContentsObserver::DispatchBlockedEvent(
         ctx->request_url, ctx->frame_tree_node_id, brave_shields::kAds);
   } else if (then_check_uncloaked) {
-    // This will be deleted by `AdblockCnameResolveHostClient::OnComplete`.
-    new AdblockCnameResolveHostClient(std::move(next_callback), task_runner,
-                                      ctx, result);
+    if (!CanResolveCnameForRequest(*ctx)) {
+      next_callback.Run();
+      return;
+    }
+    // Runs synchronously if the canonical name is already cached.
+    GetAdblockCnameCache(ctx->browser_context)
+        ->GetCanonicalName(
+            net::HostPortPair::FromURL(ctx->request_url),
+            ctx->network_anonymization_key,
+            base::BindOnce(&UseCnameResult, next_callback, ctx, result));
     return;
   }
   next_callback.Run();
 }
 
-void UseCnameResult(scoped_refptr<base::SequencedTaskRunner> task_runner,
-                    const ResponseCallback& next_callback,
+void UseCnameResult(const ResponseCallback& next_callback,
                     std::shared_ptr<BraveRequestInfo> ctx,
                     EngineFlags previous_result,
                     absl::optional<std::string> cname) {
@@ -254,12 +289,9 @@ void UseCnameResult(scoped_refptr<base::SequencedTaskRunner> task_runner,
     replacements.SetHostStr(cname->c_str());
     const GURL canonical_url = ctx->request_url.ReplaceComponents(replacements);
 
-    task_runner->PostTaskAndReplyWithResult(
-        FROM_HERE,
-        base::BindOnce(&ShouldBlockRequestOnTaskRunner, ctx, previous_result,
-                       absl::make_optional<GURL>(canonical_url)),
-        base::BindOnce(&OnShouldBlockRequestResult, false, task_runner,
-                       next_callback, ctx));
+    PostShouldBlockRequest(
+        ctx, previous_result, absl::make_optional<GURL>(canonical_url),
+        base::BindOnce(&OnShouldBlockRequestResult, false, next_callback, ctx));
   } else {
     next_callback.Run();
   }
@@ -318,9 +350,6 @@ void OnBeforeURLRequestAdBlockTP(const ResponseCallback& next_callback,
   DCHECK(!ctx->request_url.is_empty());
   DCHECK(!ctx->initiator_url.is_empty());
 
-  scoped_refptr<base::SequencedTaskRunner> task_runner =
-      g_brave_browser_process->ad_block_service()->GetTaskRunner();
-
   SecureDnsConfig secure_dns_config =
       SystemNetworkContextManager::GetStubResolverConfigReader()
           ->GetSecureDnsConfiguration(false);
@@ -349,12 +378,24 @@ void OnBeforeURLRequestAdBlockTP(const ResponseCallback& next_callback,
     should_check_uncloaked = false;
   }
 
-  task_runner->PostTaskAndReplyWithResult(
-      FROM_HERE,
-      base::BindOnce(&ShouldBlockRequestOnTaskRunner, ctx, EngineFlags(),
-                     absl::nullopt),
+  // Start resolving the host while the request is matched against the
+  // engines, so that the canonical name is likely to be known by the time it's
+  // needed. Hosts which the engines block are left alone, so that no DNS
+  // queries are made for them.
+  if (should_check_uncloaked && ctx->initiator_url.is_valid() &&
+      base::FeatureList::IsEnabled(
+          brave_shields::features::kBraveAdblockCnameCache) &&
+      CanResolveCnameForRequest(*ctx)) {
+    GetAdblockCnameCache(ctx->browser_context)
+        ->Prefetch(net::HostPortPair::FromURL(ctx->request_url),
+                   ctx->network_anonymization_key,
+                   base::BindOnce(&EnginesAllowHost, ctx));
+  }
+
+  PostShouldBlockRequest(
+      ctx, EngineFlags(), absl::nullopt,
       base::BindOnce(&OnShouldBlockRequestResult, should_check_uncloaked,
-                     task_runner, next_callback, ctx));
+                     next_callback, ctx));
 }
 
 int OnBeforeURLRequest_AdBlockTPPreWork(const ResponseCallback& next_callback,
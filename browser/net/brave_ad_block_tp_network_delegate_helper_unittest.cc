@@ -11,6 +11,7 @@
 
 #include "base/memory/raw_ptr.h"
 #include "base/path_service.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "brave/browser/brave_browser_process.h"
 #include "brave/browser/net/url_context.h"
@@ -18,6 +19,7 @@
 #include "brave/components/brave_shields/browser/ad_block_subscription_download_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_service_manager.h"
 #include "brave/components/brave_shields/browser/test_filters_provider.h"
+#include "brave/components/brave_shields/common/features.h"
 #include "brave/components/constants/network_constants.h"
 #include "brave/test/base/testing_brave_browser_process.h"
 #include "chrome/browser/net/system_network_context_manager.h"
@@ -76,6 +78,21 @@ class TestingBraveComponentUpdaterDelegate : public BraveComponent::Delegate {
   raw_ptr<PrefService> local_state_ = nullptr;
 };
 
+bool IsBlockedBySnapshots(
+    const brave_shields::AdBlockService::EngineSnapshots& snapshots,
+    const GURL& url) {
+  bool did_match_rule = false;
+  bool did_match_exception = false;
+  bool did_match_important = false;
+  std::string mock_data_url;
+  std::string rewritten_url;
+  snapshots.ShouldStartRequest(url, blink::mojom::ResourceType::kScript,
+                               "bravesoftware.com", false, &did_match_rule,
+                               &did_match_exception, &did_match_important,
+                               &mock_data_url, &rewritten_url);
+  return did_match_important || (did_match_rule && !did_match_exception);
+}
+
 }  // namespace
 
 void FakeAdBlockSubscriptionDownloadManagerGetter(
@@ -259,3 +276,88 @@ TEST_F(BraveAdBlockTPNetworkDelegateHelperTest, AggressiveNo1pException) {
   // made (`browser_context` is `nullptr`).
   EXPECT_EQ(0ULL, host_resolver_->num_resolve());
 }
+
+class BraveAdBlockTPNetworkDelegateHelperParallelMatchingTest
+    : public BraveAdBlockTPNetworkDelegateHelperTest {
+ public:
+  BraveAdBlockTPNetworkDelegateHelperParallelMatchingTest() {
+    feature_list_.InitAndEnableFeature(
+        brave_shields::features::kBraveAdblockParallelMatching);
+  }
+
+ private:
+  base::test::ScopedFeatureList feature_list_;
+};
+
+TEST_F(BraveAdBlockTPNetworkDelegateHelperParallelMatchingTest,
+       SimpleBlocking) {
+  ResetAdblockInstance("||brave.com/test.txt", "");
+  task_environment_.RunUntilIdle();
+
+  const GURL url("https://brave.com/test.txt");
+  auto request_info = std::make_shared<brave::BraveRequestInfo>(url);
+  request_info->request_identifier = 1;
+  request_info->resource_type = blink::mojom::ResourceType::kScript;
+  request_info->initiator_url = GURL("https://bravesoftware.com");
+
+  EXPECT_TRUE(CheckRequest(request_info));
+  EXPECT_EQ(request_info->blocked_by, brave::kAdBlocked);
+  EXPECT_TRUE(request_info->new_url_spec.empty());
+  EXPECT_EQ(0ULL, host_resolver_->num_resolve());
+}
+
+TEST_F(BraveAdBlockTPNetworkDelegateHelperParallelMatchingTest,
+       Default1pException) {
+  ResetAdblockInstance("||brave.com/test.txt", "");
+  task_environment_.RunUntilIdle();
+
+  const GURL url("https://brave.com/test.txt");
+  auto request_info = std::make_shared<brave::BraveRequestInfo>(url);
+  request_info->request_identifier = 1;
+  request_info->resource_type = blink::mojom::ResourceType::kScript;
+  request_info->initiator_url = GURL("https://brave.com");
+
+  EXPECT_TRUE(CheckRequest(request_info));
+  EXPECT_EQ(request_info->blocked_by, brave::kNotBlocked);
+  EXPECT_TRUE(request_info->new_url_spec.empty());
+}
+
+// Snapshots taken before a list reloads keep matching against the old rules.
+TEST_F(BraveAdBlockTPNetworkDelegateHelperParallelMatchingTest,
+       SnapshotSurvivesReload) {
+  ResetAdblockInstance("||brave.com/old.txt", "");
+  task_environment_.RunUntilIdle();
+  auto* ad_block_service = g_brave_browser_process->ad_block_service();
+  const auto old_snapshots = ad_block_service->GetEngineSnapshots();
+
+  ResetAdblockInstance("||brave.com/new.txt", "");
+  task_environment_.RunUntilIdle();
+  const auto new_snapshots = ad_block_service->GetEngineSnapshots();
+
+  EXPECT_TRUE(
+      IsBlockedBySnapshots(old_snapshots, GURL("https://brave.com/old.txt")));
+  EXPECT_FALSE(
+      IsBlockedBySnapshots(old_snapshots, GURL("https://brave.com/new.txt")));
+  EXPECT_FALSE(
+      IsBlockedBySnapshots(new_snapshots, GURL("https://brave.com/old.txt")));
+  EXPECT_TRUE(
+      IsBlockedBySnapshots(new_snapshots, GURL("https://brave.com/new.txt")));
+}
+
+// Enabling a tag while a snapshot is in use rebuilds the engine rather than
+// modifying the client the snapshot refers to.
+TEST_F(BraveAdBlockTPNetworkDelegateHelperParallelMatchingTest,
+       TagChangeDoesNotModifySnapshot) {
+  ResetAdblockInstance("||brave.com/tagged.txt$tag=test-tag", "");
+  task_environment_.RunUntilIdle();
+  auto* ad_block_service = g_brave_browser_process->ad_block_service();
+  const auto old_snapshots = ad_block_service->GetEngineSnapshots();
+
+  ad_block_service->EnableTag("test-tag", true);
+  task_environment_.RunUntilIdle();
+  const auto new_snapshots = ad_block_service->GetEngineSnapshots();
+
+  const GURL url("https://brave.com/tagged.txt");
+  EXPECT_FALSE(IsBlockedBySnapshots(old_snapshots, url));
+  EXPECT_TRUE(IsBlockedBySnapshots(new_snapshots, url));
+}
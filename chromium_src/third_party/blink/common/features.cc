@@ -64,6 +64,12 @@ BASE_FEATURE(kBraveBlockScreenFingerprinting,
              "BraveBlockScreenFingerprinting",
              base::FEATURE_DISABLED_BY_DEFAULT);
 
+// Farbles canvas readbacks with a fast keyed hash of the pixels, so that only
+// a short digest goes through HMAC-SHA256 instead of the whole canvas.
+BASE_FEATURE(kBraveFastCanvasFarbling,
+             "BraveFastCanvasFarbling",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
 // Enables HTTPS-Only Mode in Private Windows with Tor by default.
 BASE_FEATURE(kBraveTorWindowsHttpsOnly,
              "BraveTorWindowsHttpsOnly",
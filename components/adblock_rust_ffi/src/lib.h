@@ -78,7 +78,7 @@ struct C_Engine* engine_create_with_metadata(
  * within this engine, rather than being replaced with results just for this
  * engine.
  */
-void engine_match(struct C_Engine* engine,
+void engine_match(const struct C_Engine* engine,
                   const char* url,
                   const char* host,
                   const char* tab_host,
@@ -94,7 +94,7 @@ void engine_match(struct C_Engine* engine,
  * Returns any CSP directives that should be added to a subdocument or document
  * request's response headers.
  */
-char* engine_get_csp_directives(struct C_Engine* engine,
+char* engine_get_csp_directives(const struct C_Engine* engine,
                                 const char* url,
                                 const char* host,
                                 const char* tab_host,
@@ -119,7 +119,7 @@ fn engine_create_from_str(rules: &str) -> (*mut FilterListMetadata, *mut Engine)
 /// being replaced with results just for this engine.
 #[no_mangle]
 pub unsafe extern "C" fn engine_match(
-    engine: *mut Engine,
+    engine: *const Engine,
     url: *const c_char,
     host: *const c_char,
     tab_host: *const c_char,
@@ -136,7 +136,7 @@ pub unsafe extern "C" fn engine_match(
     let tab_host = CStr::from_ptr(tab_host).to_str().unwrap();
     let resource_type = CStr::from_ptr(resource_type).to_str().unwrap();
     assert!(!engine.is_null());
-    let engine = Box::leak(Box::from_raw(engine));
+    let engine = &*engine;
     let blocker_result = engine.check_network_urls_with_hostnames_subset(
         url,
         host,
@@ -165,7 +165,7 @@ pub unsafe extern "C" fn engine_match(
 /// headers.
 #[no_mangle]
 pub unsafe extern "C" fn engine_get_csp_directives(
-    engine: *mut Engine,
+    engine: *const Engine,
     url: *const c_char,
     host: *const c_char,
     tab_host: *const c_char,
@@ -177,7 +177,7 @@ pub unsafe extern "C" fn engine_get_csp_directives(
     let tab_host = CStr::from_ptr(tab_host).to_str().unwrap();
     let resource_type = CStr::from_ptr(resource_type).to_str().unwrap();
     assert!(!engine.is_null());
-    let engine = Box::leak(Box::from_raw(engine));
+    let engine = &*engine;
     if let Some(directive) =
         engine.get_csp_directives(url, host, tab_host, resource_type, Some(third_party))
     {
@@ -86,7 +86,7 @@ void Engine::matches(const std::string& url,
                      bool* did_match_exception,
                      bool* did_match_important,
                      std::string* redirect,
-                     std::string* rewritten_url) {
+                     std::string* rewritten_url) const {
   char* redirect_char_ptr = nullptr;
   char* rewritten_url_ptr = nullptr;
   engine_match(raw, url.c_str(), host.c_str(), tab_host.c_str(), is_third_party,
@@ -110,7 +110,7 @@ std::string Engine::getCspDirectives(const std::string& url,
                                      const std::string& host,
                                      const std::string& tab_host,
                                      bool is_third_party,
-                                     const std::string& resource_type) {
+                                     const std::string& resource_type) const {
   char* csp_raw = engine_get_csp_directives(raw, url.c_str(), host.c_str(),
                                             tab_host.c_str(), is_third_party,
                                             resource_type.c_str());
@@ -75,12 +75,12 @@ class ADBLOCK_EXPORT Engine {
                bool* did_match_exception,
                bool* did_match_important,
                std::string* redirect,
-               std::string* rewritten_url);
+               std::string* rewritten_url) const;
   std::string getCspDirectives(const std::string& url,
                                const std::string& host,
                                const std::string& tab_host,
                                bool is_third_party,
-                               const std::string& resource_type);
+                               const std::string& resource_type) const;
   bool deserialize(const char* data, size_t data_size);
   void addTag(const std::string& tag);
   void addResource(const std::string& key,
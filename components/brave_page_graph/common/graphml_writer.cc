@@ -0,0 +1,228 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_page_graph/common/graphml_writer.h"
+
+#include <stdint.h>
+
+#include "base/check.h"
+#include "base/strings/string_piece.h"
+
+namespace brave_page_graph {
+
+namespace {
+
+// libxml2 stops reading its arguments at the first NUL.
+base::StringPiece UpToNul(const std::string& value) {
+  return base::StringPiece(value.c_str());
+}
+
+// Same escaping as libxml2 applies to the content of text nodes.
+void AppendEscapedText(base::StringPiece text, std::string* output) {
+  for (const char c : text) {
+    switch (c) {
+      case '<':
+        output->append("&lt;");
+        break;
+      case '>':
+        output->append("&gt;");
+        break;
+      case '&':
+        output->append("&amp;");
+        break;
+      case '\r':
+        output->append("&#13;");
+        break;
+      default:
+        output->push_back(c);
+    }
+  }
+}
+
+// Same escaping as libxml2 applies to attribute values.
+void AppendEscapedAttribute(base::StringPiece value, std::string* output) {
+  for (const char c : value) {
+    switch (c) {
+      case '<':
+        output->append("&lt;");
+        break;
+      case '>':
+        output->append("&gt;");
+        break;
+      case '&':
+        output->append("&amp;");
+        break;
+      case '"':
+        output->append("&quot;");
+        break;
+      case '\n':
+        output->append("&#10;");
+        break;
+      case '\r':
+        output->append("&#13;");
+        break;
+      case '\t':
+        output->append("&#9;");
+        break;
+      default:
+        output->push_back(c);
+    }
+  }
+}
+
+bool IsXMLChar(uint32_t c) {
+  return c == 0x9 || c == 0xA || c == 0xD || (c >= 0x20 && c <= 0xD7FF) ||
+         (c >= 0xE000 && c <= 0xFFFD) || (c >= 0x10000 && c <= 0x10FFFF);
+}
+
+void AppendUTF8(uint32_t c, std::string* output) {
+  if (c < 0x80) {
+    output->push_back(static_cast<char>(c));
+  } else if (c < 0x800) {
+    output->push_back(static_cast<char>(0xC0 | (c >> 6)));
+    output->push_back(static_cast<char>(0x80 | (c & 0x3F)));
+  } else if (c < 0x10000) {
+    output->push_back(static_cast<char>(0xE0 | (c >> 12)));
+    output->push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | (c & 0x3F)));
+  } else {
+    output->push_back(static_cast<char>(0xF0 | (c >> 18)));
+    output->push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | (c & 0x3F)));
+  }
+}
+
+// String values used to go through xmlEncodeEntitiesReentrant() and be parsed
+// back into text nodes. That drops the control characters which aren't
+// allowed in XML, and reads a byte which doesn't start a valid character as
+// Latin-1. From then on, libxml2 copies any non-ASCII byte of the document as
+// it is, which |copy_non_ascii| keeps track of. This does the same, so that
+// the text, once escaped, comes out unchanged.
+std::string ToXMLText(base::StringPiece value, bool* copy_non_ascii) {
+  std::string text;
+  text.reserve(value.size());
+  const auto* bytes = reinterpret_cast<const uint8_t*>(value.data());
+  size_t i = 0;
+  while (i < value.size()) {
+    const uint8_t c = bytes[i];
+    if (c < 0x80) {
+      if (c >= 0x20 || c == '\t' || c == '\n' || c == '\r') {
+        text.push_back(static_cast<char>(c));
+      }
+      i++;
+      continue;
+    }
+    if (*copy_non_ascii) {
+      text.push_back(static_cast<char>(c));
+      i++;
+      continue;
+    }
+    // Overlong sequences are accepted, as they are by libxml2.
+    size_t length = 1;
+    uint32_t code_point = 0;
+    if (c >= 0xC0 && c < 0xE0) {
+      length = 2;
+      code_point = c & 0x1F;
+    } else if (c >= 0xE0 && c < 0xF0) {
+      length = 3;
+      code_point = c & 0x0F;
+    } else if (c >= 0xF0 && c < 0xF8) {
+      length = 4;
+      code_point = c & 0x07;
+    }
+    for (size_t j = 1; j < length; j++) {
+      if (i + j >= value.size() || (bytes[i + j] & 0xC0) != 0x80) {
+        length = 1;
+        break;
+      }
+      code_point = (code_point << 6) | (bytes[i + j] & 0x3F);
+    }
+    if (length == 1 || !IsXMLChar(code_point)) {
+      AppendUTF8(c, &text);
+      *copy_non_ascii = true;
+      i++;
+      continue;
+    }
+    AppendUTF8(code_point, &text);
+    i += length;
+  }
+  return text;
+}
+
+}  // namespace
+
+GraphMLWriter::GraphMLWriter(std::string* output) : output_(output) {}
+
+GraphMLWriter::~GraphMLWriter() = default;
+
+void GraphMLWriter::StartDocument() {
+  output_->append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+}
+
+void GraphMLWriter::StartElement(const char* name) {
+  CloseStartTag();
+  output_->push_back('<');
+  output_->append(name);
+  open_elements_.push_back(name);
+  start_tag_open_ = true;
+}
+
+void GraphMLWriter::AddAttribute(const char* name, const std::string& value) {
+  DCHECK(start_tag_open_);
+  output_->push_back(' ');
+  output_->append(name);
+  output_->append("=\"");
+  AppendEscapedAttribute(UpToNul(value), output_);
+  output_->push_back('"');
+}
+
+void GraphMLWriter::AddText(const std::string& text) {
+  DCHECK(!open_elements_.empty());
+  CloseStartTag();
+  AppendEscapedText(UpToNul(text), output_);
+}
+
+void GraphMLWriter::AddEncodedText(const std::string& value) {
+  const std::string text = ToXMLText(UpToNul(value), &copy_non_ascii_);
+  if (!text.empty()) {
+    AddText(text);
+  }
+}
+
+void GraphMLWriter::AddTextElement(const char* name, const std::string& text) {
+  StartElement(name);
+  AddText(text);
+  EndElement();
+}
+
+void GraphMLWriter::EndElement() {
+  DCHECK(!open_elements_.empty());
+  if (start_tag_open_) {
+    output_->append("/>");
+    start_tag_open_ = false;
+  } else {
+    output_->append("</");
+    output_->append(open_elements_.back());
+    output_->push_back('>');
+  }
+  open_elements_.pop_back();
+}
+
+void GraphMLWriter::EndDocument() {
+  while (!open_elements_.empty()) {
+    EndElement();
+  }
+  output_->push_back('\n');
+}
+
+void GraphMLWriter::CloseStartTag() {
+  if (start_tag_open_) {
+    output_->push_back('>');
+    start_tag_open_ = false;
+  }
+}
+
+}  // namespace brave_page_graph
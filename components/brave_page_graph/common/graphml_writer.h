@@ -0,0 +1,61 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_PAGE_GRAPH_COMMON_GRAPHML_WRITER_H_
+#define BRAVE_COMPONENTS_BRAVE_PAGE_GRAPH_COMMON_GRAPHML_WRITER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/memory/raw_ptr.h"
+
+namespace brave_page_graph {
+
+// Writes GraphML straight to a string, without building a document first.
+// Text and attribute values are escaped the same way libxml2 serializes them,
+// so the output is byte for byte what dumping the equivalent xmlDoc with the
+// UTF-8 encoding gives. The output string can be swapped between calls, so
+// that a large graph can be written out a chunk at a time.
+class GraphMLWriter {
+ public:
+  explicit GraphMLWriter(std::string* output);
+  GraphMLWriter(const GraphMLWriter&) = delete;
+  GraphMLWriter& operator=(const GraphMLWriter&) = delete;
+  ~GraphMLWriter();
+
+  void set_output(std::string* output) { output_ = output; }
+
+  // Writes the XML declaration.
+  void StartDocument();
+  // Opens an element, which attributes can be added to until it gets any
+  // content. Elements left without content are written as empty-element tags.
+  void StartElement(const char* name);
+  void AddAttribute(const char* name, const std::string& value);
+  // Adds a text node to the open element, which then always gets an end tag,
+  // even if |text| is empty.
+  void AddText(const std::string& text);
+  // Adds |value| as it used to be added with xmlEncodeEntitiesReentrant(),
+  // which leaves out what can't be represented in XML. The open element is
+  // left without content if nothing remains.
+  void AddEncodedText(const std::string& value);
+  void AddTextElement(const char* name, const std::string& text);
+  void EndElement();
+  // Closes any open elements and ends the document.
+  void EndDocument();
+
+ private:
+  void CloseStartTag();
+
+  raw_ptr<std::string> output_;
+  std::vector<const char*> open_elements_;
+  bool start_tag_open_ = false;
+  // Set once a value which isn't valid UTF-8 has been encoded, see
+  // AddEncodedText().
+  bool copy_non_ascii_ = false;
+};
+
+}  // namespace brave_page_graph
+
+#endif  // BRAVE_COMPONENTS_BRAVE_PAGE_GRAPH_COMMON_GRAPHML_WRITER_H_
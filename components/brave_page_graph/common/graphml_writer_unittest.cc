@@ -0,0 +1,176 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_page_graph/common/graphml_writer.h"
+
+#include <string>
+#include <vector>
+
+#include "base/callback_helpers.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/path_service.h"
+#include "base/test/bind.h"
+#include "base/threading/thread_restrictions.h"
+#include "brave/components/constants/brave_paths.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_page_graph {
+
+namespace {
+
+// The golden file was written by libxml2, building the same document with
+// xmlNewTextChild() for AddText(), xmlNewChild() with the value passed
+// through xmlEncodeEntitiesReentrant() for AddEncodedText(), and dumping it
+// with xmlDocDumpMemoryEnc() in UTF-8, as PageGraph::ToGraphML() used to.
+std::string ReadGoldenFile() {
+  base::ScopedAllowBlockingForTesting allow_blocking;
+  base::FilePath test_data_dir;
+  CHECK(base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir));
+  std::string golden;
+  CHECK(base::ReadFileToString(
+      test_data_dir.AppendASCII("brave_page_graph")
+          .AppendASCII("graphml_writer_golden.graphml"),
+      &golden));
+  return golden;
+}
+
+// Writes the golden document, calling |after_each_call| after each call to
+// the writer.
+void WriteGoldenDocument(GraphMLWriter* writer,
+                         const base::RepeatingClosure& after_each_call) {
+  auto data = [&](const char* key) {
+    writer->StartElement("data");
+    after_each_call.Run();
+    writer->AddAttribute("key", key);
+    after_each_call.Run();
+  };
+  auto end = [&]() {
+    writer->EndElement();
+    after_each_call.Run();
+  };
+
+  writer->StartDocument();
+  after_each_call.Run();
+  writer->StartElement("graphml");
+  after_each_call.Run();
+  writer->AddAttribute("xmlns", "http://graphml.graphdrawing.org/xmlns");
+  after_each_call.Run();
+
+  writer->StartElement("desc");
+  after_each_call.Run();
+  writer->AddTextElement("version", "0.3.0");
+  after_each_call.Run();
+  // Elements with empty text still get an end tag.
+  writer->AddTextElement("frame_id", "");
+  after_each_call.Run();
+  end();
+
+  writer->StartElement("key");
+  after_each_call.Run();
+  writer->AddAttribute("id", "d1");
+  after_each_call.Run();
+  writer->AddAttribute("attr.name", "a <b> & \"c\" 'd'\t\n\r");
+  after_each_call.Run();
+  end();
+
+  writer->StartElement("graph");
+  after_each_call.Run();
+  writer->AddAttribute("id", "G");
+  after_each_call.Run();
+
+  // Escaping of text.
+  writer->StartElement("node");
+  after_each_call.Run();
+  writer->AddAttribute("id", "n1");
+  after_each_call.Run();
+  data("d1");
+  writer->AddText("<script>&amp;\"'\r\n\t</script>");
+  after_each_call.Run();
+  end();
+  data("d2");
+  writer->AddEncodedText("a<b>&c \"q\" 'q' \r\n\t");
+  after_each_call.Run();
+  end();
+  // Control characters which XML doesn't allow are dropped.
+  data("d3");
+  writer->AddEncodedText("\x01\x02kept\x1f\x7f end");
+  after_each_call.Run();
+  end();
+  // Values with nothing left get an empty-element tag.
+  data("d4");
+  writer->AddEncodedText("\x03");
+  after_each_call.Run();
+  end();
+  data("d5");
+  writer->AddEncodedText("h\xC3\xA9llo \xE2\x9C\x93 \xF0\x9D\x84\x9E");
+  after_each_call.Run();
+  end();
+  // Values stop at the first NUL.
+  data("d6");
+  writer->AddEncodedText(std::string("before\0after", 12));
+  after_each_call.Run();
+  end();
+  end();
+
+  // A byte which isn't valid UTF-8 is read as Latin-1, and from then on
+  // non-ASCII bytes are copied as they are, even in later values.
+  writer->StartElement("node");
+  after_each_call.Run();
+  writer->AddAttribute("id", "n2");
+  after_each_call.Run();
+  data("d1");
+  writer->AddEncodedText("caf\xE9 \xE2\x9C\x93");
+  after_each_call.Run();
+  end();
+  data("d2");
+  writer->AddEncodedText("\xFF\xFE ok \xC3\xA9");
+  after_each_call.Run();
+  end();
+  end();
+
+  writer->StartElement("node");
+  after_each_call.Run();
+  writer->AddAttribute("id", "n3");
+  after_each_call.Run();
+  end();
+
+  writer->EndDocument();
+  after_each_call.Run();
+}
+
+}  // namespace
+
+TEST(GraphMLWriterTest, MatchesLibxmlSerialization) {
+  std::string output;
+  GraphMLWriter writer(&output);
+  WriteGoldenDocument(&writer, base::DoNothing());
+
+  EXPECT_EQ(ReadGoldenFile(), output);
+}
+
+TEST(GraphMLWriterTest, ChunkedOutputMatchesUnchunkedOutput) {
+  std::string unchunked;
+  GraphMLWriter unchunked_writer(&unchunked);
+  WriteGoldenDocument(&unchunked_writer, base::DoNothing());
+
+  // Write each call to a chunk of its own, including in the middle of start
+  // tags.
+  std::vector<std::string> chunks(1);
+  GraphMLWriter chunked_writer(&chunks.back());
+  WriteGoldenDocument(&chunked_writer, base::BindLambdaForTesting([&]() {
+                        chunks.emplace_back();
+                        chunked_writer.set_output(&chunks.back());
+                      }));
+
+  std::string joined;
+  for (const std::string& chunk : chunks) {
+    joined += chunk;
+  }
+  EXPECT_GT(chunks.size(), 1u);
+  EXPECT_EQ(unchunked, joined);
+}
+
+}  // namespace brave_page_graph
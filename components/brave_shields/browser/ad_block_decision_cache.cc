@@ -0,0 +1,95 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_decision_cache.h"
+
+namespace brave_shields {
+
+AdBlockDecisionCache::AdBlockDecisionCache(size_t max_entries)
+    : decisions_(max_entries), csp_directives_(max_entries) {
+  // The cache is created on the UI thread but used on the adblock task runner.
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+AdBlockDecisionCache::~AdBlockDecisionCache() = default;
+
+absl::optional<AdBlockDecisionCache::Decision>
+AdBlockDecisionCache::GetDecision(const GURL& url,
+                                  blink::mojom::ResourceType resource_type,
+                                  const std::string& tab_host,
+                                  bool aggressive_blocking,
+                                  uint64_t generation) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  MaybeInvalidate(generation);
+
+  auto it = decisions_.Get(
+      Key(tab_host, url.spec(), resource_type, aggressive_blocking));
+  if (it == decisions_.end()) {
+    decision_miss_count_++;
+    return absl::nullopt;
+  }
+
+  decision_hit_count_++;
+  saved_match_time_ += it->second.match_time;
+  return it->second;
+}
+
+void AdBlockDecisionCache::PutDecision(const GURL& url,
+                                       blink::mojom::ResourceType resource_type,
+                                       const std::string& tab_host,
+                                       bool aggressive_blocking,
+                                       uint64_t generation,
+                                       const Decision& decision) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  MaybeInvalidate(generation);
+
+  decisions_.Put(Key(tab_host, url.spec(), resource_type, aggressive_blocking),
+                 decision);
+}
+
+absl::optional<absl::optional<std::string>>
+AdBlockDecisionCache::GetCspDirectives(const GURL& url,
+                                       blink::mojom::ResourceType resource_type,
+                                       const std::string& tab_host,
+                                       uint64_t generation) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  MaybeInvalidate(generation);
+
+  // CSP directives don't depend on the blocking mode.
+  auto it =
+      csp_directives_.Get(Key(tab_host, url.spec(), resource_type, false));
+  if (it == csp_directives_.end()) {
+    csp_miss_count_++;
+    return absl::nullopt;
+  }
+
+  csp_hit_count_++;
+  return it->second;
+}
+
+void AdBlockDecisionCache::PutCspDirectives(
+    const GURL& url,
+    blink::mojom::ResourceType resource_type,
+    const std::string& tab_host,
+    uint64_t generation,
+    const absl::optional<std::string>& csp_directives) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  MaybeInvalidate(generation);
+
+  csp_directives_.Put(Key(tab_host, url.spec(), resource_type, false),
+                      csp_directives);
+}
+
+void AdBlockDecisionCache::MaybeInvalidate(uint64_t generation) {
+  if (generation == generation_) {
+    return;
+  }
+
+  decisions_.Clear();
+  csp_directives_.Clear();
+  generation_ = generation;
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,104 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_DECISION_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_DECISION_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <tuple>
+
+#include "base/containers/lru_cache.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+// Caches the combined result of matching a request against all of the adblock
+// engines, keyed on the tab host, request URL, resource type and blocking
+// mode, so that subresources which repeat across pages and tabs are only
+// matched once. All entries are dropped when the engine generation changes,
+// i.e. whenever the rules, tags or resources of any engine change.
+class AdBlockDecisionCache {
+ public:
+  struct Decision {
+    bool did_match_rule = false;
+    bool did_match_exception = false;
+    bool did_match_important = false;
+    std::string mock_data_url;
+    std::string rewritten_url;
+    // How long matching took when the decision was made.
+    base::TimeDelta match_time;
+  };
+
+  static constexpr size_t kDefaultMaxEntries = 1000;
+
+  explicit AdBlockDecisionCache(size_t max_entries = kDefaultMaxEntries);
+  AdBlockDecisionCache(const AdBlockDecisionCache&) = delete;
+  AdBlockDecisionCache& operator=(const AdBlockDecisionCache&) = delete;
+  ~AdBlockDecisionCache();
+
+  absl::optional<Decision> GetDecision(const GURL& url,
+                                       blink::mojom::ResourceType resource_type,
+                                       const std::string& tab_host,
+                                       bool aggressive_blocking,
+                                       uint64_t generation);
+  void PutDecision(const GURL& url,
+                   blink::mojom::ResourceType resource_type,
+                   const std::string& tab_host,
+                   bool aggressive_blocking,
+                   uint64_t generation,
+                   const Decision& decision);
+
+  // The outer optional is empty on a cache miss.
+  absl::optional<absl::optional<std::string>> GetCspDirectives(
+      const GURL& url,
+      blink::mojom::ResourceType resource_type,
+      const std::string& tab_host,
+      uint64_t generation);
+  void PutCspDirectives(const GURL& url,
+                        blink::mojom::ResourceType resource_type,
+                        const std::string& tab_host,
+                        uint64_t generation,
+                        const absl::optional<std::string>& csp_directives);
+
+  // Request decisions and CSP directives are counted separately, since they
+  // are looked up for different requests and hit at different rates.
+  size_t decision_hit_count() const { return decision_hit_count_; }
+  size_t decision_miss_count() const { return decision_miss_count_; }
+  size_t csp_hit_count() const { return csp_hit_count_; }
+  size_t csp_miss_count() const { return csp_miss_count_; }
+  // The total time which matching would have taken for the request decisions
+  // which were served from the cache.
+  base::TimeDelta saved_match_time() const { return saved_match_time_; }
+
+ private:
+  using Key =
+      std::tuple<std::string, std::string, blink::mojom::ResourceType, bool>;
+
+  // Drops all entries if |generation| differs from that of the entries.
+  void MaybeInvalidate(uint64_t generation);
+
+  uint64_t generation_ = 0;
+  base::LRUCache<Key, Decision> decisions_;
+  base::LRUCache<Key, absl::optional<std::string>> csp_directives_;
+
+  size_t decision_hit_count_ = 0;
+  size_t decision_miss_count_ = 0;
+  size_t csp_hit_count_ = 0;
+  size_t csp_miss_count_ = 0;
+  base::TimeDelta saved_match_time_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_DECISION_CACHE_H_
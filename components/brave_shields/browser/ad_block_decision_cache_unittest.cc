@@ -0,0 +1,120 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_decision_cache.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr char kTabHost[] = "example.com";
+
+AdBlockDecisionCache::Decision BlockedDecision() {
+  AdBlockDecisionCache::Decision decision;
+  decision.did_match_rule = true;
+  decision.rewritten_url = "https://tracker.com/rewritten.js";
+  decision.match_time = base::Microseconds(100);
+  return decision;
+}
+
+}  // namespace
+
+TEST(AdBlockDecisionCacheTest, HitAfterPut) {
+  AdBlockDecisionCache cache;
+  const GURL url("https://tracker.com/script.js");
+
+  EXPECT_FALSE(cache.GetDecision(url, blink::mojom::ResourceType::kScript,
+                                 kTabHost, false, 1));
+  cache.PutDecision(url, blink::mojom::ResourceType::kScript, kTabHost, false,
+                    1, BlockedDecision());
+  auto decision = cache.GetDecision(url, blink::mojom::ResourceType::kScript,
+                                    kTabHost, false, 1);
+
+  ASSERT_TRUE(decision);
+  EXPECT_TRUE(decision->did_match_rule);
+  EXPECT_FALSE(decision->did_match_exception);
+  EXPECT_EQ("https://tracker.com/rewritten.js", decision->rewritten_url);
+  EXPECT_EQ(1u, cache.decision_hit_count());
+  EXPECT_EQ(1u, cache.decision_miss_count());
+  EXPECT_EQ(0u, cache.csp_hit_count());
+  EXPECT_EQ(0u, cache.csp_miss_count());
+  EXPECT_EQ(base::Microseconds(100), cache.saved_match_time());
+}
+
+TEST(AdBlockDecisionCacheTest, KeyIncludesRequestContext) {
+  AdBlockDecisionCache cache;
+  const GURL url("https://tracker.com/script.js");
+  cache.PutDecision(url, blink::mojom::ResourceType::kScript, kTabHost, false,
+                    1, BlockedDecision());
+
+  EXPECT_FALSE(cache.GetDecision(url, blink::mojom::ResourceType::kImage,
+                                 kTabHost, false, 1));
+  EXPECT_FALSE(cache.GetDecision(url, blink::mojom::ResourceType::kScript,
+                                 "other.com", false, 1));
+  EXPECT_FALSE(cache.GetDecision(url, blink::mojom::ResourceType::kScript,
+                                 kTabHost, true, 1));
+  EXPECT_FALSE(cache.GetDecision(GURL("https://tracker.com/other.js"),
+                                 blink::mojom::ResourceType::kScript, kTabHost,
+                                 false, 1));
+}
+
+TEST(AdBlockDecisionCacheTest, GenerationChangeInvalidates) {
+  AdBlockDecisionCache cache;
+  const GURL url("https://tracker.com/script.js");
+  cache.PutDecision(url, blink::mojom::ResourceType::kScript, kTabHost, false,
+                    1, BlockedDecision());
+  cache.PutCspDirectives(url, blink::mojom::ResourceType::kSubFrame, kTabHost,
+                         1, "script-src 'none'");
+
+  EXPECT_FALSE(cache.GetDecision(url, blink::mojom::ResourceType::kScript,
+                                 kTabHost, false, 2));
+  EXPECT_FALSE(cache.GetCspDirectives(
+      url, blink::mojom::ResourceType::kSubFrame, kTabHost, 2));
+  // Entries from the previous generation don't come back either.
+  EXPECT_FALSE(cache.GetDecision(url, blink::mojom::ResourceType::kScript,
+                                 kTabHost, false, 1));
+}
+
+TEST(AdBlockDecisionCacheTest, CachesMissingCspDirectives) {
+  AdBlockDecisionCache cache;
+  const GURL url("https://example.com/frame.html");
+  cache.PutCspDirectives(url, blink::mojom::ResourceType::kSubFrame, kTabHost,
+                         1, absl::nullopt);
+
+  auto csp_directives = cache.GetCspDirectives(
+      url, blink::mojom::ResourceType::kSubFrame, kTabHost, 1);
+  ASSERT_TRUE(csp_directives);
+  EXPECT_FALSE(*csp_directives);
+  EXPECT_EQ(1u, cache.csp_hit_count());
+  EXPECT_EQ(0u, cache.csp_miss_count());
+  EXPECT_EQ(0u, cache.decision_hit_count());
+}
+
+TEST(AdBlockDecisionCacheTest, EvictsLeastRecentlyUsed) {
+  AdBlockDecisionCache cache(2);
+  const GURL first("https://tracker.com/1.js");
+  const GURL second("https://tracker.com/2.js");
+  const GURL third("https://tracker.com/3.js");
+  cache.PutDecision(first, blink::mojom::ResourceType::kScript, kTabHost, false,
+                    1, BlockedDecision());
+  cache.PutDecision(second, blink::mojom::ResourceType::kScript, kTabHost,
+                    false, 1, BlockedDecision());
+  EXPECT_TRUE(cache.GetDecision(first, blink::mojom::ResourceType::kScript,
+                                kTabHost, false, 1));
+  cache.PutDecision(third, blink::mojom::ResourceType::kScript, kTabHost, false,
+                    1, BlockedDecision());
+
+  EXPECT_TRUE(cache.GetDecision(first, blink::mojom::ResourceType::kScript,
+                                kTabHost, false, 1));
+  EXPECT_FALSE(cache.GetDecision(second, blink::mojom::ResourceType::kScript,
+                                 kTabHost, false, 1));
+  EXPECT_TRUE(cache.GetDecision(third, blink::mojom::ResourceType::kScript,
+                                kTabHost, false, 1));
+}
+
+}  // namespace brave_shields
@@ -5,6 +5,7 @@
 
 #include "brave/components/brave_shields/browser/ad_block_engine.h"
 
+#include <atomic>
 #include <set>
 #include <string>
 #include <utility>
@@ -12,14 +13,17 @@
 
 #include "base/bind.h"
 #include "base/containers/contains.h"
+#include "base/feature_list.h"
 #include "base/files/file_path.h"
 #include "base/json/json_reader.h"
+#include "base/logging.h"
 #include "base/memory/ptr_util.h"
 #include "base/ranges/algorithm.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "brave/components/brave_shields/common/features.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/origin.h"
@@ -94,23 +98,31 @@ std::string ResourceTypeToString(blink::mojom::ResourceType resource_type) {
   return filter_option;
 }
 
+// Constant-initialized, so safe to have as a global.
+std::atomic<uint64_t> g_generation{0};
+
 }  // namespace
 
 namespace brave_shields {
 
-AdBlockEngine::AdBlockEngine() : ad_block_client_(new adblock::Engine()) {}
+AdBlockEngineSnapshot::AdBlockEngineSnapshot(
+    std::unique_ptr<adblock::Engine> ad_block_client)
+    : ad_block_client_(std::move(ad_block_client)) {
+  DCHECK(ad_block_client_);
+}
 
-AdBlockEngine::~AdBlockEngine() = default;
+AdBlockEngineSnapshot::~AdBlockEngineSnapshot() = default;
 
-void AdBlockEngine::ShouldStartRequest(const GURL& url,
-                                       blink::mojom::ResourceType resource_type,
-                                       const std::string& tab_host,
-                                       bool aggressive_blocking,
-                                       bool* did_match_rule,
-                                       bool* did_match_exception,
-                                       bool* did_match_important,
-                                       std::string* mock_data_url,
-                                       std::string* rewritten_url) {
+void AdBlockEngineSnapshot::ShouldStartRequest(
+    const GURL& url,
+    blink::mojom::ResourceType resource_type,
+    const std::string& tab_host,
+    bool aggressive_blocking,
+    bool* did_match_rule,
+    bool* did_match_exception,
+    bool* did_match_important,
+    std::string* mock_data_url,
+    std::string* rewritten_url) const {
   // Determine third-party here so the library doesn't need to figure it out.
   // CreateFromNormalizedTuple is needed because SameDomainOrHost needs
   // a URL or origin and not a string to a host name.
@@ -122,6 +134,31 @@ void AdBlockEngine::ShouldStartRequest(const GURL& url,
                             ResourceTypeToString(resource_type), did_match_rule,
                             did_match_exception, did_match_important,
                             mock_data_url, rewritten_url);
+}
+
+AdBlockEngine::AdBlockEngine()
+    : snapshot_(base::MakeRefCounted<AdBlockEngineSnapshot>(
+          std::make_unique<adblock::Engine>())),
+      keep_source_(base::FeatureList::IsEnabled(
+          features::kBraveAdblockParallelMatching)) {}
+
+AdBlockEngine::~AdBlockEngine() {
+  IncrementGeneration();
+}
+
+void AdBlockEngine::ShouldStartRequest(const GURL& url,
+                                       blink::mojom::ResourceType resource_type,
+                                       const std::string& tab_host,
+                                       bool aggressive_blocking,
+                                       bool* did_match_rule,
+                                       bool* did_match_exception,
+                                       bool* did_match_important,
+                                       std::string* mock_data_url,
+                                       std::string* rewritten_url) {
+  snapshot_->ShouldStartRequest(url, resource_type, tab_host,
+                                aggressive_blocking, did_match_rule,
+                                did_match_exception, did_match_important,
+                                mock_data_url, rewritten_url);
 
   // LOG(ERROR) << "AdBlockEngine::ShouldStartRequest(), host: "
   //  << tab_host
@@ -140,7 +177,7 @@ absl::optional<std::string> AdBlockEngine::GetCspDirectives(
       url,
       url::Origin::CreateFromNormalizedTuple("https", tab_host.c_str(), 80),
       INCLUDE_PRIVATE_REGISTRIES);
-  const std::string result = ad_block_client_->getCspDirectives(
+  const std::string result = ad_block_client()->getCspDirectives(
       url.spec(), url.host(), tab_host, is_third_party,
       ResourceTypeToString(resource_type));
 
@@ -154,17 +191,32 @@ absl::optional<std::string> AdBlockEngine::GetCspDirectives(
 void AdBlockEngine::EnableTag(const std::string& tag, bool enabled) {
   if (enabled) {
     if (tags_.find(tag) == tags_.end()) {
-      ad_block_client_->addTag(tag);
       tags_.insert(tag);
+      ModifyClient(base::BindOnce(
+          [](const std::string& tag, adblock::Engine* ad_block_client) {
+            ad_block_client->addTag(tag);
+          },
+          tag));
     }
   } else {
-    ad_block_client_->removeTag(tag);
     tags_.erase(tag);
+    ModifyClient(base::BindOnce(
+        [](const std::string& tag, adblock::Engine* ad_block_client) {
+          ad_block_client->removeTag(tag);
+        },
+        tag));
   }
 }
 
 void AdBlockEngine::AddResources(const std::string& resources) {
-  ad_block_client_->addResources(resources);
+  if (keep_source_) {
+    resources_json_ = resources;
+  }
+  ModifyClient(base::BindOnce(
+      [](const std::string& resources, adblock::Engine* ad_block_client) {
+        ad_block_client->addResources(resources);
+      },
+      resources));
 }
 
 bool AdBlockEngine::TagExists(const std::string& tag) {
@@ -173,7 +225,7 @@ bool AdBlockEngine::TagExists(const std::string& tag) {
 
 absl::optional<base::Value> AdBlockEngine::UrlCosmeticResources(
     const std::string& url) {
-  return base::JSONReader::Read(ad_block_client_->urlCosmeticResources(url));
+  return base::JSONReader::Read(ad_block_client()->urlCosmeticResources(url));
 }
 
 base::Value::List AdBlockEngine::HiddenClassIdSelectors(
@@ -181,7 +233,7 @@ base::Value::List AdBlockEngine::HiddenClassIdSelectors(
     const std::vector<std::string>& ids,
     const std::vector<std::string>& exceptions) {
   absl::optional<base::Value> result = base::JSONReader::Read(
-      ad_block_client_->hiddenClassIdSelectors(classes, ids, exceptions));
+      ad_block_client()->hiddenClassIdSelectors(classes, ids, exceptions));
 
   if (!result) {
     return base::Value::List();
@@ -206,22 +258,48 @@ absl::optional<adblock::FilterListMetadata> AdBlockEngine::Load(
 void AdBlockEngine::UpdateAdBlockClient(
     std::unique_ptr<adblock::Engine> ad_block_client,
     const std::string& resources_json) {
-  ad_block_client_ = std::move(ad_block_client);
-  AddResources(resources_json);
-  AddKnownTagsToAdBlockInstance();
+  // The new client is set up before it is swapped in, since it can be used
+  // on other threads as soon as it is.
+  ad_block_client->addResources(resources_json);
+  for (const auto& tag : tags_) {
+    ad_block_client->addTag(tag);
+  }
+  if (keep_source_) {
+    resources_json_ = resources_json;
+  }
+  SetSnapshot(std::move(ad_block_client));
   if (test_observer_) {
     test_observer_->OnEngineUpdated();
   }
 }
 
-void AdBlockEngine::AddKnownTagsToAdBlockInstance() {
-  std::for_each(tags_.begin(), tags_.end(),
-                [&](const std::string tag) { ad_block_client_->addTag(tag); });
+bool AdBlockEngine::IsLoaded() const {
+  return is_loaded_;
+}
+
+// static
+uint64_t AdBlockEngine::GetGeneration() {
+  return g_generation.load(std::memory_order_relaxed);
+}
+
+// static
+void AdBlockEngine::IncrementGeneration() {
+  g_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+scoped_refptr<AdBlockEngineSnapshot> AdBlockEngine::GetSnapshot() {
+  base::AutoLock lock(snapshot_lock_);
+  return is_loaded_ ? snapshot_ : nullptr;
 }
 
 adblock::FilterListMetadata AdBlockEngine::OnListSourceLoaded(
     const DATFileDataBuffer& filters,
     const std::string& resources_json) {
+  if (keep_source_) {
+    has_source_ = true;
+    source_deserialize_ = false;
+    source_ = filters;
+  }
   auto metadata_and_engine = adblock::engineFromBufferWithMetadata(
       reinterpret_cast<const char*>(filters.data()), filters.size());
   UpdateAdBlockClient(std::move(metadata_and_engine.second), resources_json);
@@ -235,6 +313,11 @@ void AdBlockEngine::OnDATLoaded(const DATFileDataBuffer& dat_buf,
     return;
   }
 
+  if (keep_source_) {
+    has_source_ = true;
+    source_deserialize_ = true;
+    source_ = dat_buf;
+  }
   auto client = std::make_unique<adblock::Engine>();
   client->deserialize(reinterpret_cast<const char*>(&dat_buf.front()),
                       dat_buf.size());
@@ -242,6 +325,62 @@ void AdBlockEngine::OnDATLoaded(const DATFileDataBuffer& dat_buf,
   UpdateAdBlockClient(std::move(client), resources_json);
 }
 
+void AdBlockEngine::ModifyClient(
+    base::OnceCallback<void(adblock::Engine*)> modify) {
+  {
+    // Snapshots are only handed out under the lock, so a client with no other
+    // references can't start being used elsewhere while it is modified.
+    base::AutoLock lock(snapshot_lock_);
+    if (snapshot_->HasOneRef()) {
+      std::move(modify).Run(snapshot_->ad_block_client_.get());
+      IncrementGeneration();
+      return;
+    }
+  }
+
+  std::unique_ptr<adblock::Engine> ad_block_client = RebuildClient();
+  if (!ad_block_client) {
+    // Engines which were compiled elsewhere, like the merged engine, are
+    // replaced by their owner rather than modified.
+    LOG(WARNING) << "Dropping modification of an adblock engine in use";
+    return;
+  }
+  SetSnapshot(std::move(ad_block_client));
+}
+
+std::unique_ptr<adblock::Engine> AdBlockEngine::RebuildClient() const {
+  if (!has_source_) {
+    return nullptr;
+  }
+
+  std::unique_ptr<adblock::Engine> ad_block_client;
+  if (source_deserialize_) {
+    ad_block_client = std::make_unique<adblock::Engine>();
+    ad_block_client->deserialize(
+        reinterpret_cast<const char*>(source_.data()), source_.size());
+  } else {
+    ad_block_client = std::make_unique<adblock::Engine>(
+        reinterpret_cast<const char*>(source_.data()), source_.size());
+  }
+  ad_block_client->addResources(resources_json_);
+  for (const auto& tag : tags_) {
+    ad_block_client->addTag(tag);
+  }
+  return ad_block_client;
+}
+
+void AdBlockEngine::SetSnapshot(
+    std::unique_ptr<adblock::Engine> ad_block_client) {
+  auto snapshot =
+      base::MakeRefCounted<AdBlockEngineSnapshot>(std::move(ad_block_client));
+  base::AutoLock lock(snapshot_lock_);
+  // The previous client is destroyed by whichever thread drops the last
+  // reference to it.
+  snapshot_.swap(snapshot);
+  is_loaded_ = true;
+  IncrementGeneration();
+}
+
 void AdBlockEngine::AddObserverForTest(AdBlockEngine::TestObserver* observer) {
   test_observer_ = observer;
 }
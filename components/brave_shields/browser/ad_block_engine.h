@@ -14,8 +14,12 @@
 #include <utility>
 #include <vector>
 
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list_types.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
 #include "base/values.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
@@ -36,6 +40,36 @@ class PerfPredictorTabHelperTest;
 
 namespace brave_shields {
 
+// A compiled adblock client which can be matched against on any thread.
+// AdBlockEngine never modifies a client once a snapshot of it may be in use, so
+// a snapshot stays valid while the engine moves on to a reloaded client.
+class AdBlockEngineSnapshot
+    : public base::RefCountedThreadSafe<AdBlockEngineSnapshot> {
+ public:
+  explicit AdBlockEngineSnapshot(
+      std::unique_ptr<adblock::Engine> ad_block_client);
+  AdBlockEngineSnapshot(const AdBlockEngineSnapshot&) = delete;
+  AdBlockEngineSnapshot& operator=(const AdBlockEngineSnapshot&) = delete;
+
+  void ShouldStartRequest(const GURL& url,
+                          blink::mojom::ResourceType resource_type,
+                          const std::string& tab_host,
+                          bool aggressive_blocking,
+                          bool* did_match_rule,
+                          bool* did_match_exception,
+                          bool* did_match_important,
+                          std::string* mock_data_url,
+                          std::string* rewritten_url) const;
+
+ private:
+  friend class base::RefCountedThreadSafe<AdBlockEngineSnapshot>;
+  friend class AdBlockEngine;
+
+  ~AdBlockEngineSnapshot();
+
+  const std::unique_ptr<adblock::Engine> ad_block_client_;
+};
+
 // Service managing an adblock engine.
 class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
  public:
@@ -75,6 +109,26 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
       const DATFileDataBuffer& dat_buf,
       const std::string& resources_json);
 
+  // Replaces the engine with one which was compiled elsewhere, e.g. on the
+  // thread pool so that matching is not blocked while it compiles.
+  void UpdateAdBlockClient(std::unique_ptr<adblock::Engine> ad_block_client,
+                           const std::string& resources_json);
+
+  // Returns true once an engine has been loaded.
+  bool IsLoaded() const;
+
+  // Returns a counter which changes whenever the rules, tags or resources of
+  // any engine change, or an engine is removed, so that results combined from
+  // several engines can be cached. May be called on any thread.
+  static uint64_t GetGeneration();
+  // Marks results combined from several engines as stale without an engine
+  // changing, e.g. when an engine stops being queried.
+  static void IncrementGeneration();
+
+  // Returns the current client for matching off of the engine's task runner,
+  // or nullptr if no engine has been loaded yet. May be called on any thread.
+  scoped_refptr<AdBlockEngineSnapshot> GetSnapshot();
+
   class TestObserver : public base::CheckedObserver {
    public:
     virtual void OnEngineUpdated() = 0;
@@ -84,9 +138,6 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
   void RemoveObserverForTest();
 
  protected:
-  void AddKnownTagsToAdBlockInstance();
-  void UpdateAdBlockClient(std::unique_ptr<adblock::Engine> ad_block_client,
-                           const std::string& resources_json);
   adblock::FilterListMetadata OnListSourceLoaded(
       const DATFileDataBuffer& filters,
       const std::string& resources_json);
@@ -94,7 +145,9 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
   void OnDATLoaded(const DATFileDataBuffer& dat_buf,
                    const std::string& resources_json);
 
-  std::unique_ptr<adblock::Engine> ad_block_client_;
+  adblock::Engine* ad_block_client() const {
+    return snapshot_->ad_block_client_.get();
+  }
 
  private:
   friend class ::AdBlockServiceTest;
@@ -102,8 +155,30 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
   friend class ::EphemeralStorage1pDomainBlockBrowserTest;
   friend class ::PerfPredictorTabHelperTest;
 
+  // Runs |modify| on the current client if no snapshot of it is in use.
+  // Otherwise the client is rebuilt from its source, which already reflects
+  // the modification, and swapped in for new snapshots.
+  void ModifyClient(base::OnceCallback<void(adblock::Engine*)> modify);
+  std::unique_ptr<adblock::Engine> RebuildClient() const;
+
+  void SetSnapshot(std::unique_ptr<adblock::Engine> ad_block_client);
+
   std::set<std::string> tags_;
 
+  // Only written on the engine's task runner, so reads there don't need to
+  // hold |snapshot_lock_|.
+  base::Lock snapshot_lock_;
+  scoped_refptr<AdBlockEngineSnapshot> snapshot_;
+  bool is_loaded_ = false;
+
+  // In parallel matching mode the source of the client is kept so that it can
+  // be rebuilt instead of being modified while a snapshot of it is in use.
+  const bool keep_source_;
+  bool has_source_ = false;
+  bool source_deserialize_ = false;
+  DATFileDataBuffer source_;
+  std::string resources_json_;
+
   raw_ptr<TestObserver> test_observer_ = nullptr;
 };
 
@@ -0,0 +1,168 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_merged_engine_manager.h"
+
+#include <set>
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/task/thread_pool.h"
+#include "brave/components/adblock_rust_ffi/src/wrapper.h"
+
+namespace brave_shields {
+
+namespace {
+
+void CompileEngine(const DATFileDataBuffer& filters,
+                   const std::set<std::string>& tags,
+                   scoped_refptr<base::SequencedTaskRunner> task_runner,
+                   base::WeakPtr<AdBlockEngine> engine,
+                   const std::string& resources_json) {
+  auto ad_block_client =
+      filters.empty() ? std::make_unique<adblock::Engine>()
+                      : std::make_unique<adblock::Engine>(
+                            reinterpret_cast<const char*>(filters.data()),
+                            filters.size());
+  for (const auto& tag : tags) {
+    ad_block_client->addTag(tag);
+  }
+
+  task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&AdBlockEngine::UpdateAdBlockClient, engine,
+                                std::move(ad_block_client), resources_json));
+}
+
+}  // namespace
+
+AdBlockMergedEngineManager::ListInfo::ListInfo() = default;
+
+AdBlockMergedEngineManager::ListInfo::~ListInfo() = default;
+
+AdBlockMergedEngineManager::AdBlockMergedEngineManager(
+    scoped_refptr<base::SequencedTaskRunner> task_runner,
+    AdBlockResourceProvider* resource_provider)
+    : task_runner_(task_runner),
+      compile_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      resource_provider_(resource_provider),
+      engine_(new AdBlockEngine(), base::OnTaskRunnerDeleter(task_runner_)) {
+  DCHECK(resource_provider_);
+  resource_provider_->AddObserver(this);
+}
+
+AdBlockMergedEngineManager::~AdBlockMergedEngineManager() {
+  resource_provider_->RemoveObserver(this);
+}
+
+void AdBlockMergedEngineManager::SetList(const std::string& list_id,
+                                         bool deserialize,
+                                         const DATFileDataBuffer& filters) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  if (deserialize) {
+    LOG(WARNING) << "Cannot merge serialized filter list " << list_id;
+    return;
+  }
+
+  lists_[list_id].filters = filters;
+  ScheduleRebuild();
+}
+
+void AdBlockMergedEngineManager::SetListEnabled(const std::string& list_id,
+                                                bool enabled) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  ListInfo& list = lists_[list_id];
+  if (list.enabled == enabled) {
+    return;
+  }
+
+  list.enabled = enabled;
+  ScheduleRebuild();
+}
+
+void AdBlockMergedEngineManager::RemoveList(const std::string& list_id) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  if (lists_.erase(list_id) == 0) {
+    return;
+  }
+
+  ScheduleRebuild();
+}
+
+void AdBlockMergedEngineManager::EnableTag(const std::string& tag,
+                                           bool enabled) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  const bool changed =
+      enabled ? tags_.insert(tag).second : tags_.erase(tag) > 0;
+  if (!changed) {
+    return;
+  }
+
+  // Like resources, tags can't be modified on the merged engine while a
+  // snapshot of it is in use, so recompile it with the new tags.
+  ScheduleRebuild();
+}
+
+AdBlockEngine* AdBlockMergedEngineManager::GetEngineIfLoaded() {
+  DCHECK(task_runner_->RunsTasksInCurrentSequence());
+  return engine_->IsLoaded() ? engine_.get() : nullptr;
+}
+
+void AdBlockMergedEngineManager::OnResourcesLoaded(
+    const std::string& resources_json) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // The merged engine has no source to rebuild from, so it can't be modified
+  // while a snapshot of it is in use. Recompile it with the new resources
+  // instead.
+  ScheduleRebuild();
+}
+
+scoped_refptr<AdBlockEngineSnapshot>
+AdBlockMergedEngineManager::GetEngineSnapshot() {
+  return engine_->GetSnapshot();
+}
+
+void AdBlockMergedEngineManager::ScheduleRebuild() {
+  rebuild_timer_.Start(FROM_HERE, kRebuildDelay,
+                       base::BindOnce(&AdBlockMergedEngineManager::Rebuild,
+                                      weak_factory_.GetWeakPtr()));
+}
+
+void AdBlockMergedEngineManager::Rebuild() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  DATFileDataBuffer filters;
+  for (const auto& [list_id, list] : lists_) {
+    if (!list.enabled || list.filters.empty()) {
+      continue;
+    }
+
+    filters.insert(filters.end(), list.filters.cbegin(), list.filters.cend());
+    filters.push_back('\n');
+  }
+
+  resource_provider_->LoadResources(base::BindOnce(
+      &AdBlockMergedEngineManager::OnResourcesLoadedForRebuild,
+      weak_factory_.GetWeakPtr(), std::move(filters), tags_));
+}
+
+void AdBlockMergedEngineManager::OnResourcesLoadedForRebuild(
+    DATFileDataBuffer filters,
+    std::set<std::string> tags,
+    const std::string& resources_json) {
+  compile_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&CompileEngine, std::move(filters),
+                                std::move(tags), task_runner_,
+                                engine_->AsWeakPtr(), resources_json));
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,108 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MERGED_ENGINE_MANAGER_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MERGED_ENGINE_MANAGER_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "base/memory/raw_ptr.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/ad_block_engine.h"
+#include "brave/components/brave_shields/browser/ad_block_resource_provider.h"
+
+using brave_component_updater::DATFileDataBuffer;
+
+namespace brave_shields {
+
+// Compiles the filter lists of the enabled regional lists, list subscriptions
+// and custom filters into a single engine so that each request is matched
+// against all of them at once. The engine is recompiled on the thread pool
+// whenever a list is updated, enabled or removed, and the previous engine
+// keeps serving requests until the new one is swapped in on |task_runner|.
+class AdBlockMergedEngineManager : public AdBlockResourceProvider::Observer {
+ public:
+  // Coalesces list updates which arrive together, i.e. at startup or when a
+  // component update installs several lists.
+  static constexpr base::TimeDelta kRebuildDelay = base::Seconds(1);
+
+  AdBlockMergedEngineManager(
+      scoped_refptr<base::SequencedTaskRunner> task_runner,
+      AdBlockResourceProvider* resource_provider);
+  AdBlockMergedEngineManager(const AdBlockMergedEngineManager&) = delete;
+  AdBlockMergedEngineManager& operator=(const AdBlockMergedEngineManager&) =
+      delete;
+  ~AdBlockMergedEngineManager() override;
+
+  // Sets the filter list text for |list_id|. Serialized engines cannot be
+  // merged, so lists which are only available as DAT files are ignored.
+  void SetList(const std::string& list_id,
+               bool deserialize,
+               const DATFileDataBuffer& filters);
+  void SetListEnabled(const std::string& list_id, bool enabled);
+  void RemoveList(const std::string& list_id);
+  // Tags are applied to every merged engine compiled from now on.
+  void EnableTag(const std::string& tag, bool enabled);
+
+  // Must be called on |task_runner|. Returns nullptr until the merged engine
+  // has been compiled for the first time.
+  AdBlockEngine* GetEngineIfLoaded();
+  // May be called on any thread. Returns nullptr until the merged engine has
+  // been compiled for the first time.
+  scoped_refptr<AdBlockEngineSnapshot> GetEngineSnapshot();
+
+  base::WeakPtr<AdBlockMergedEngineManager> AsWeakPtr() {
+    return weak_factory_.GetWeakPtr();
+  }
+
+ private:
+  struct ListInfo {
+    ListInfo();
+    ListInfo(const ListInfo&) = delete;
+    ListInfo& operator=(const ListInfo&) = delete;
+    ~ListInfo();
+
+    DATFileDataBuffer filters;
+    bool enabled = true;
+  };
+
+  // AdBlockResourceProvider::Observer
+  void OnResourcesLoaded(const std::string& resources_json) override;
+
+  void ScheduleRebuild();
+  void Rebuild();
+  void OnResourcesLoadedForRebuild(DATFileDataBuffer filters,
+                                   std::set<std::string> tags,
+                                   const std::string& resources_json);
+
+  std::map<std::string, ListInfo> lists_;
+  std::set<std::string> tags_;
+  base::OneShotTimer rebuild_timer_;
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  // Compiles are sequenced so that engines are swapped in the order in which
+  // they were requested.
+  scoped_refptr<base::SequencedTaskRunner> compile_task_runner_;
+  raw_ptr<AdBlockResourceProvider> resource_provider_;  // not owned
+
+  std::unique_ptr<AdBlockEngine, base::OnTaskRunnerDeleter> engine_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  base::WeakPtrFactory<AdBlockMergedEngineManager> weak_factory_{this};
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MERGED_ENGINE_MANAGER_H_
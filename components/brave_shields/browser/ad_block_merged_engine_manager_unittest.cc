@@ -0,0 +1,242 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_merged_engine_manager.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/test/task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/time/time.h"
+#include "base/time/time_override.h"
+#include "brave/components/brave_shields/browser/ad_block_engine.h"
+#include "brave/components/brave_shields/browser/test_filters_provider.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr char kTabHost[] = "example.com";
+
+DATFileDataBuffer ToBuffer(const std::string& rules) {
+  return DATFileDataBuffer(rules.cbegin(), rules.cend());
+}
+
+bool IsBlocked(AdBlockEngine* engine, const std::string& url) {
+  bool did_match_rule = false;
+  bool did_match_exception = false;
+  bool did_match_important = false;
+  std::string mock_data_url;
+  std::string rewritten_url;
+  engine->ShouldStartRequest(GURL(url), blink::mojom::ResourceType::kScript,
+                             kTabHost, /*aggressive_blocking*/ false,
+                             &did_match_rule, &did_match_exception,
+                             &did_match_important, &mock_data_url,
+                             &rewritten_url);
+  return did_match_rule && !did_match_exception;
+}
+
+std::string BuildRules(const int list, const int rule_count) {
+  std::string rules;
+  for (int i = 0; i < rule_count; i++) {
+    rules += "||tracker" + base::NumberToString(i) + ".list" +
+             base::NumberToString(list) + ".com^\n";
+  }
+  return rules;
+}
+
+}  // namespace
+
+class AdBlockMergedEngineManagerTest : public testing::Test {
+ public:
+  AdBlockMergedEngineManagerTest()
+      : resource_provider_("", "[]"),
+        manager_(base::SequencedTaskRunnerHandle::Get(), &resource_provider_) {}
+
+ protected:
+  void WaitForRebuild() {
+    task_environment_.FastForwardBy(AdBlockMergedEngineManager::kRebuildDelay);
+    task_environment_.RunUntilIdle();
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  TestFiltersProvider resource_provider_;
+  AdBlockMergedEngineManager manager_;
+};
+
+TEST_F(AdBlockMergedEngineManagerTest, NotLoadedUntilRebuilt) {
+  manager_.SetList("a", false, ToBuffer("||a.com^"));
+
+  EXPECT_EQ(nullptr, manager_.GetEngineIfLoaded());
+}
+
+TEST_F(AdBlockMergedEngineManagerTest, MergesLists) {
+  manager_.SetList("a", false, ToBuffer("||a.com^"));
+  manager_.SetList("b", false, ToBuffer("||b.com^"));
+  WaitForRebuild();
+
+  AdBlockEngine* engine = manager_.GetEngineIfLoaded();
+  ASSERT_TRUE(engine);
+  EXPECT_TRUE(IsBlocked(engine, "https://a.com/script.js"));
+  EXPECT_TRUE(IsBlocked(engine, "https://b.com/script.js"));
+  EXPECT_FALSE(IsBlocked(engine, "https://c.com/script.js"));
+}
+
+TEST_F(AdBlockMergedEngineManagerTest, ExceptionFromAnotherListApplies) {
+  manager_.SetList("a", false, ToBuffer("||a.com^"));
+  manager_.SetList("b", false, ToBuffer("@@||a.com/allowed.js"));
+  WaitForRebuild();
+
+  AdBlockEngine* engine = manager_.GetEngineIfLoaded();
+  ASSERT_TRUE(engine);
+  EXPECT_TRUE(IsBlocked(engine, "https://a.com/script.js"));
+  EXPECT_FALSE(IsBlocked(engine, "https://a.com/allowed.js"));
+}
+
+TEST_F(AdBlockMergedEngineManagerTest, DisabledListIsNotMerged) {
+  manager_.SetList("a", false, ToBuffer("||a.com^"));
+  manager_.SetList("b", false, ToBuffer("||b.com^"));
+  manager_.SetListEnabled("b", false);
+  WaitForRebuild();
+
+  AdBlockEngine* engine = manager_.GetEngineIfLoaded();
+  ASSERT_TRUE(engine);
+  EXPECT_TRUE(IsBlocked(engine, "https://a.com/script.js"));
+  EXPECT_FALSE(IsBlocked(engine, "https://b.com/script.js"));
+
+  manager_.SetListEnabled("b", true);
+  WaitForRebuild();
+
+  EXPECT_TRUE(IsBlocked(engine, "https://b.com/script.js"));
+}
+
+TEST_F(AdBlockMergedEngineManagerTest, RemovedListIsNotMerged) {
+  manager_.SetList("a", false, ToBuffer("||a.com^"));
+  manager_.SetList("b", false, ToBuffer("||b.com^"));
+  WaitForRebuild();
+
+  manager_.RemoveList("b");
+  WaitForRebuild();
+
+  AdBlockEngine* engine = manager_.GetEngineIfLoaded();
+  ASSERT_TRUE(engine);
+  EXPECT_TRUE(IsBlocked(engine, "https://a.com/script.js"));
+  EXPECT_FALSE(IsBlocked(engine, "https://b.com/script.js"));
+}
+
+TEST_F(AdBlockMergedEngineManagerTest, IgnoresSerializedLists) {
+  manager_.SetList("a", false, ToBuffer("||a.com^"));
+  manager_.SetList("b", true, ToBuffer("not a list"));
+  WaitForRebuild();
+
+  AdBlockEngine* engine = manager_.GetEngineIfLoaded();
+  ASSERT_TRUE(engine);
+  EXPECT_TRUE(IsBlocked(engine, "https://a.com/script.js"));
+}
+
+TEST_F(AdBlockMergedEngineManagerTest, AppliesEnabledTags) {
+  manager_.SetList("regional", false, ToBuffer("||tagged.com^$tag=sup"));
+  WaitForRebuild();
+
+  AdBlockEngine* engine = manager_.GetEngineIfLoaded();
+  ASSERT_TRUE(engine);
+  EXPECT_FALSE(IsBlocked(engine, "https://tagged.com/script.js"));
+
+  manager_.EnableTag("sup", true);
+  WaitForRebuild();
+
+  EXPECT_TRUE(IsBlocked(engine, "https://tagged.com/script.js"));
+
+  // Tags are kept when the list is updated.
+  manager_.SetList("regional", false,
+                   ToBuffer("||tagged.com^$tag=sup\n||a.com^"));
+  WaitForRebuild();
+
+  EXPECT_TRUE(IsBlocked(engine, "https://tagged.com/script.js"));
+  EXPECT_TRUE(IsBlocked(engine, "https://a.com/script.js"));
+
+  manager_.EnableTag("sup", false);
+  WaitForRebuild();
+
+  EXPECT_FALSE(IsBlocked(engine, "https://tagged.com/script.js"));
+}
+
+TEST_F(AdBlockMergedEngineManagerTest, BenchmarkShouldStartRequest) {
+  constexpr int kListCount = 8;
+  constexpr int kRulesPerList = 2'000;
+  constexpr int kRequestCount = 10'000;
+
+  std::vector<std::unique_ptr<AdBlockEngine>> engines;
+  for (int list = 0; list < kListCount; list++) {
+    const DATFileDataBuffer filters = ToBuffer(BuildRules(list, kRulesPerList));
+    auto engine = std::make_unique<AdBlockEngine>();
+    engine->Load(/*deserialize*/ false, filters, "[]");
+    engines.push_back(std::move(engine));
+    manager_.SetList(base::NumberToString(list), false, filters);
+  }
+  WaitForRebuild();
+
+  AdBlockEngine* merged_engine = manager_.GetEngineIfLoaded();
+  ASSERT_TRUE(merged_engine);
+
+  // One in four requests is to a blocked host.
+  std::vector<std::string> urls;
+  for (int i = 0; i < kRequestCount; i++) {
+    const std::string host =
+        i % 4 == 0 ? "tracker" + base::NumberToString(i % kRulesPerList) +
+                         ".list" + base::NumberToString(i % kListCount) + ".com"
+                   : "cdn" + base::NumberToString(i) + ".example.net";
+    urls.push_back("https://" + host + "/script.js");
+  }
+
+  // Like AdBlockService, every list is queried for every request.
+  int serial_blocked_count = 0;
+  base::TimeTicks start_time = base::subtle::TimeTicksNowIgnoringOverride();
+  for (const auto& url : urls) {
+    bool is_blocked = false;
+    for (const auto& engine : engines) {
+      is_blocked |= IsBlocked(engine.get(), url);
+    }
+    if (is_blocked) {
+      serial_blocked_count++;
+    }
+  }
+  const base::TimeDelta serial_time =
+      base::subtle::TimeTicksNowIgnoringOverride() - start_time;
+
+  int merged_blocked_count = 0;
+  start_time = base::subtle::TimeTicksNowIgnoringOverride();
+  for (const auto& url : urls) {
+    if (IsBlocked(merged_engine, url)) {
+      merged_blocked_count++;
+    }
+  }
+  const base::TimeDelta merged_time =
+      base::subtle::TimeTicksNowIgnoringOverride() - start_time;
+
+  EXPECT_EQ(kRequestCount / 4, serial_blocked_count);
+  EXPECT_EQ(serial_blocked_count, merged_blocked_count);
+
+  perf_test::PerfResultReporter reporter(
+      "AdBlockMergedEngine",
+      base::NumberToString(kListCount) + "_lists_" +
+          base::NumberToString(kRulesPerList) + "_rules");
+  reporter.RegisterImportantMetric(".serial_requests_per_second", "count");
+  reporter.RegisterImportantMetric(".merged_requests_per_second", "count");
+  reporter.AddResult(".serial_requests_per_second",
+                     kRequestCount / serial_time.InSecondsF());
+  reporter.AddResult(".merged_requests_per_second",
+                     kRequestCount / merged_time.InSecondsF());
+}
+
+}  // namespace brave_shields
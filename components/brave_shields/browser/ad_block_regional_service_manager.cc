@@ -9,12 +9,14 @@
 #include <utility>
 #include <vector>
 
+#include "base/callback_helpers.h"
 #include "base/feature_list.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/strings/string_util.h"
 #include "base/values.h"
 #include "brave/components/brave_shields/browser/ad_block_component_filters_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_engine.h"
+#include "brave/components/brave_shields/browser/ad_block_merged_engine_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/browser/filter_list_catalog_entry.h"
@@ -43,10 +45,12 @@ AdBlockRegionalServiceManager::AdBlockRegionalServiceManager(
 
 void AdBlockRegionalServiceManager::Init(
     AdBlockResourceProvider* resource_provider,
-    AdBlockFilterListCatalogProvider* catalog_provider) {
+    AdBlockFilterListCatalogProvider* catalog_provider,
+    AdBlockMergedEngineManager* merged_engine_manager) {
   DCHECK(!initialized_);
   resource_provider_ = resource_provider;
   catalog_provider_ = catalog_provider;
+  merged_engine_manager_ = merged_engine_manager;
   catalog_provider_->LoadFilterListCatalog(
       base::BindOnce(&AdBlockRegionalServiceManager::OnFilterListCatalogLoaded,
                      weak_factory_.GetWeakPtr()));
@@ -123,7 +127,8 @@ void AdBlockRegionalServiceManager::StartRegionalServices() {
         auto observer =
             std::make_unique<AdBlockService::SourceProviderObserver>(
                 regional_service->AsWeakPtr(), regional_filters_provider.get(),
-                resource_provider_, task_runner_);
+                resource_provider_, task_runner_, base::DoNothing(),
+                GetOnFiltersLoadedCallback(uuid));
         regional_services_.insert({uuid, std::move(regional_service)});
         regional_filters_providers_.insert(
             {uuid, std::move(regional_filters_provider)});
@@ -157,6 +162,18 @@ void AdBlockRegionalServiceManager::RecordP3ACookieListEnabled() {
                         IsFilterListEnabled(kCookieListUuid));
 }
 
+base::RepeatingCallback<void(bool deserialize,
+                             const DATFileDataBuffer& dat_buf)>
+AdBlockRegionalServiceManager::GetOnFiltersLoadedCallback(
+    const std::string& uuid) {
+  if (!merged_engine_manager_) {
+    return base::DoNothing();
+  }
+
+  return base::BindRepeating(&AdBlockMergedEngineManager::SetList,
+                             merged_engine_manager_->AsWeakPtr(), uuid);
+}
+
 bool AdBlockRegionalServiceManager::Start() {
   return true;
 }
@@ -188,6 +205,16 @@ void AdBlockRegionalServiceManager::ShouldStartRequest(
   }
 }
 
+void AdBlockRegionalServiceManager::AppendEngineSnapshots(
+    std::vector<scoped_refptr<AdBlockEngineSnapshot>>* snapshots) {
+  base::AutoLock lock(regional_services_lock_);
+  for (const auto& regional_service : regional_services_) {
+    if (auto snapshot = regional_service.second->GetSnapshot()) {
+      snapshots->push_back(std::move(snapshot));
+    }
+  }
+}
+
 absl::optional<std::string> AdBlockRegionalServiceManager::GetCspDirectives(
     const GURL& url,
     blink::mojom::ResourceType resource_type,
@@ -269,7 +296,8 @@ void AdBlockRegionalServiceManager::EnableFilterList(const std::string& uuid,
             new AdBlockEngine(), base::OnTaskRunnerDeleter(task_runner_));
     auto observer = std::make_unique<AdBlockService::SourceProviderObserver>(
         regional_service->AsWeakPtr(), regional_filters_provider.get(),
-        resource_provider_, task_runner_);
+        resource_provider_, task_runner_, base::DoNothing(),
+        GetOnFiltersLoadedCallback(uuid));
     regional_services_.insert({uuid, std::move(regional_service)});
     regional_filters_providers_.insert(
         {uuid, std::move(regional_filters_provider)});
@@ -286,6 +314,10 @@ void AdBlockRegionalServiceManager::EnableFilterList(const std::string& uuid,
     DCHECK(it2 != regional_filters_providers_.end());
     std::move(*it2->second).Delete();
     regional_filters_providers_.erase(it2);
+
+    if (merged_engine_manager_) {
+      merged_engine_manager_->RemoveList(uuid);
+    }
   }
 
   // Update preferences to reflect enabled/disabled state of specified
@@ -32,6 +32,7 @@ using brave_component_updater::BraveComponent;
 
 namespace brave_shields {
 
+class AdBlockMergedEngineManager;
 class AdBlockRegionalService;
 class FilterListCatalogEntry;
 
@@ -65,6 +66,10 @@ class AdBlockRegionalServiceManager
                           bool* did_match_important,
                           std::string* mock_data_url,
                           std::string* rewritten_url);
+  // Appends snapshots of the loaded engines, in the order in which
+  // ShouldStartRequest queries them.
+  void AppendEngineSnapshots(
+      std::vector<scoped_refptr<AdBlockEngineSnapshot>>* snapshots);
   absl::optional<std::string> GetCspDirectives(
       const GURL& url,
       blink::mojom::ResourceType resource_type,
@@ -82,7 +87,8 @@ class AdBlockRegionalServiceManager
       const std::vector<std::string>& exceptions);
 
   void Init(AdBlockResourceProvider* resource_provider,
-            AdBlockFilterListCatalogProvider* catalog_provider);
+            AdBlockFilterListCatalogProvider* catalog_provider,
+            AdBlockMergedEngineManager* merged_engine_manager);
 
   // AdBlockFilterListCatalogProvider::Observer
   void OnFilterListCatalogLoaded(const std::string& catalog_json) override;
@@ -91,6 +97,9 @@ class AdBlockRegionalServiceManager
   friend class ::AdBlockServiceTest;
   void StartRegionalServices();
   void UpdateFilterListPrefs(const std::string& uuid, bool enabled);
+  base::RepeatingCallback<void(bool deserialize,
+                               const DATFileDataBuffer& dat_buf)>
+  GetOnFiltersLoadedCallback(const std::string& uuid);
 
   void RecordP3ACookieListEnabled();
 
@@ -112,6 +121,7 @@ class AdBlockRegionalServiceManager
   raw_ptr<component_updater::ComponentUpdateService> component_update_service_;
   raw_ptr<AdBlockResourceProvider> resource_provider_;
   raw_ptr<AdBlockFilterListCatalogProvider> catalog_provider_;
+  raw_ptr<AdBlockMergedEngineManager> merged_engine_manager_ = nullptr;
 
   base::WeakPtrFactory<AdBlockRegionalServiceManager> weak_factory_{this};
 };
@@ -0,0 +1,177 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_selector_cache.h"
+
+#include <utility>
+
+#include "base/containers/cxx20_erase.h"
+#include "base/containers/flat_map.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+#include "url/origin.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr char kClassPrefix[] = ".";
+constexpr char kIdPrefix[] = "#";
+
+// Characters which can follow the leading class or id of a selector.
+constexpr char kNameTerminators[] = " \t\n>+~:.[#,";
+
+// Returns the leading class or id of `selector` along with its prefix, which
+// is what the engines return the selector for, or an empty string if that
+// can't be told for sure, e.g. because of escapes or non-ASCII names.
+base::StringPiece GetSelectorKey(base::StringPiece selector) {
+  if (selector.empty() || (selector[0] != '.' && selector[0] != '#')) {
+    return base::StringPiece();
+  }
+  size_t end = 1;
+  while (end < selector.size() &&
+         (base::IsAsciiAlphaNumeric(selector[end]) || selector[end] == '-' ||
+          selector[end] == '_')) {
+    end++;
+  }
+  if (end == 1 || (end < selector.size() &&
+                   base::StringPiece(kNameTerminators).find(selector[end]) ==
+                       base::StringPiece::npos)) {
+    return base::StringPiece();
+  }
+  return selector.substr(0, end);
+}
+
+}  // namespace
+
+HiddenSelectors::HiddenSelectors() = default;
+HiddenSelectors::HiddenSelectors(const HiddenSelectors&) = default;
+HiddenSelectors::HiddenSelectors(HiddenSelectors&&) = default;
+HiddenSelectors& HiddenSelectors::operator=(const HiddenSelectors&) = default;
+HiddenSelectors& HiddenSelectors::operator=(HiddenSelectors&&) = default;
+HiddenSelectors::~HiddenSelectors() = default;
+
+void HiddenSelectors::Append(const HiddenSelectors& other) {
+  hide_selectors.insert(hide_selectors.end(), other.hide_selectors.begin(),
+                        other.hide_selectors.end());
+  force_hide_selectors.insert(force_hide_selectors.end(),
+                              other.force_hide_selectors.begin(),
+                              other.force_hide_selectors.end());
+}
+
+AdBlockSelectorCache::OriginEntry::OriginEntry() = default;
+AdBlockSelectorCache::OriginEntry::OriginEntry(OriginEntry&&) = default;
+AdBlockSelectorCache::OriginEntry&
+AdBlockSelectorCache::OriginEntry::operator=(OriginEntry&&) = default;
+AdBlockSelectorCache::OriginEntry::~OriginEntry() = default;
+
+AdBlockSelectorCache::AdBlockSelectorCache(size_t max_origins)
+    : origins_(max_origins) {
+  // The cache is created on the UI thread but used on the adblock task runner.
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+AdBlockSelectorCache::~AdBlockSelectorCache() = default;
+
+void AdBlockSelectorCache::GetSelectors(
+    const url::Origin& origin,
+    const std::vector<std::string>& exceptions,
+    uint64_t generation,
+    std::vector<std::string>* classes,
+    std::vector<std::string>* ids,
+    HiddenSelectors* selectors) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  MaybeInvalidate(generation);
+
+  auto it = origin.opaque() ? origins_.end() : origins_.Get(origin.Serialize());
+  if (it == origins_.end() || it->second.exceptions != exceptions) {
+    miss_count_ += classes->size() + ids->size();
+    return;
+  }
+
+  const std::map<std::string, HiddenSelectors>& names = it->second.names;
+  auto get_cached = [&](const char* prefix, std::vector<std::string>* list) {
+    base::EraseIf(*list, [&](const std::string& name) {
+      auto name_it = names.find(prefix + name);
+      if (name_it == names.end()) {
+        miss_count_++;
+        return false;
+      }
+      hit_count_++;
+      selectors->Append(name_it->second);
+      return true;
+    });
+  };
+  get_cached(kClassPrefix, classes);
+  get_cached(kIdPrefix, ids);
+}
+
+void AdBlockSelectorCache::PutSelectors(
+    const url::Origin& origin,
+    const std::vector<std::string>& exceptions,
+    uint64_t generation,
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
+    const HiddenSelectors& selectors) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  MaybeInvalidate(generation);
+  // If an engine changed while matching, |generation| is already stale and
+  // the selectors are dropped the next time the cache is used.
+  if (origin.opaque() || generation != generation_) {
+    return;
+  }
+
+  std::vector<std::pair<std::string, HiddenSelectors>> batch;
+  batch.reserve(classes.size() + ids.size());
+  for (const std::string& name : classes) {
+    batch.emplace_back(kClassPrefix + name, HiddenSelectors());
+  }
+  for (const std::string& name : ids) {
+    batch.emplace_back(kIdPrefix + name, HiddenSelectors());
+  }
+  base::flat_map<std::string, HiddenSelectors> names(std::move(batch));
+
+  auto attribute = [&](const std::vector<std::string>& list,
+                       std::vector<std::string> HiddenSelectors::*field) {
+    for (const std::string& selector : list) {
+      auto it = names.find(GetSelectorKey(selector));
+      if (it == names.end()) {
+        return false;
+      }
+      (it->second.*field).push_back(selector);
+    }
+    return true;
+  };
+  if (!attribute(selectors.hide_selectors, &HiddenSelectors::hide_selectors) ||
+      !attribute(selectors.force_hide_selectors,
+                 &HiddenSelectors::force_hide_selectors)) {
+    return;
+  }
+
+  const std::string key = origin.Serialize();
+  auto it = origins_.Get(key);
+  if (it == origins_.end()) {
+    it = origins_.Put(key, OriginEntry());
+  }
+  OriginEntry& entry = it->second;
+  if (entry.exceptions != exceptions ||
+      entry.names.size() + names.size() > kMaxNamesPerOrigin) {
+    entry.exceptions = exceptions;
+    entry.names.clear();
+  }
+  for (auto& name : names) {
+    entry.names.insert(std::move(name));
+  }
+}
+
+void AdBlockSelectorCache::MaybeInvalidate(uint64_t generation) {
+  if (generation == generation_) {
+    return;
+  }
+  generation_ = generation;
+  origins_.Clear();
+}
+
+}  // namespace brave_shields
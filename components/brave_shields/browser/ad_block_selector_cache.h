@@ -0,0 +1,107 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_SELECTOR_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_SELECTOR_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/containers/lru_cache.h"
+#include "base/sequence_checker.h"
+
+namespace url {
+class Origin;
+}
+
+namespace brave_shields {
+
+// The generic selectors which the adblock engines hide for some classes and
+// ids. `force_hide_selectors` also apply to first party content.
+struct HiddenSelectors {
+  HiddenSelectors();
+  HiddenSelectors(const HiddenSelectors&);
+  HiddenSelectors(HiddenSelectors&&);
+  HiddenSelectors& operator=(const HiddenSelectors&);
+  HiddenSelectors& operator=(HiddenSelectors&&);
+  ~HiddenSelectors();
+
+  // Appends the selectors of `other`.
+  void Append(const HiddenSelectors& other);
+
+  std::vector<std::string> hide_selectors;
+  std::vector<std::string> force_hide_selectors;
+};
+
+// Caches the selectors hidden for each class and id, per origin, so that the
+// names which pages of an origin keep reporting, e.g. as an infinite scroll
+// page loads more content or from its frames, are only matched once.
+//
+// Engines return the selectors for a batch of names together. A selector is
+// only returned for the class or id it starts with, so that's the name it is
+// cached for; a batch is not cached at all if any of its selectors can't be
+// attributed that way. All entries are dropped when the engine generation
+// changes, and the entries of an origin when its exceptions change.
+class AdBlockSelectorCache {
+ public:
+  static constexpr size_t kDefaultMaxOrigins = 32;
+  static constexpr size_t kMaxNamesPerOrigin = 10000;
+
+  explicit AdBlockSelectorCache(size_t max_origins = kDefaultMaxOrigins);
+  AdBlockSelectorCache(const AdBlockSelectorCache&) = delete;
+  AdBlockSelectorCache& operator=(const AdBlockSelectorCache&) = delete;
+  ~AdBlockSelectorCache();
+
+  // Appends the cached selectors for `classes` and `ids` to `selectors`, and
+  // removes the names they were cached for from `classes` and `ids`.
+  void GetSelectors(const url::Origin& origin,
+                    const std::vector<std::string>& exceptions,
+                    uint64_t generation,
+                    std::vector<std::string>* classes,
+                    std::vector<std::string>* ids,
+                    HiddenSelectors* selectors);
+  // Caches the `selectors` which the engines returned for `classes` and `ids`.
+  void PutSelectors(const url::Origin& origin,
+                    const std::vector<std::string>& exceptions,
+                    uint64_t generation,
+                    const std::vector<std::string>& classes,
+                    const std::vector<std::string>& ids,
+                    const HiddenSelectors& selectors);
+
+  size_t hit_count() const { return hit_count_; }
+  size_t miss_count() const { return miss_count_; }
+
+ private:
+  struct OriginEntry {
+    OriginEntry();
+    OriginEntry(OriginEntry&&);
+    OriginEntry& operator=(OriginEntry&&);
+    ~OriginEntry();
+
+    std::vector<std::string> exceptions;
+    // Keyed on the name prefixed by "." for classes and "#" for ids, the way
+    // selectors start with it.
+    std::map<std::string, HiddenSelectors> names;
+  };
+
+  // Drops all entries if |generation| differs from that of the entries.
+  void MaybeInvalidate(uint64_t generation);
+
+  uint64_t generation_ = 0;
+  base::LRUCache<std::string, OriginEntry> origins_;
+
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_SELECTOR_CACHE_H_
@@ -0,0 +1,146 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_selector_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace brave_shields {
+
+namespace {
+
+using Names = std::vector<std::string>;
+
+url::Origin ExampleOrigin() {
+  return url::Origin::Create(GURL("https://example.com/"));
+}
+
+HiddenSelectors AdSelectors() {
+  HiddenSelectors selectors;
+  selectors.hide_selectors = {".ad", ".ad > .banner"};
+  selectors.force_hide_selectors = {".ad:not(.wide)"};
+  return selectors;
+}
+
+}  // namespace
+
+TEST(AdBlockSelectorCacheTest, ServesCachedNames) {
+  AdBlockSelectorCache cache;
+  Names classes = {"ad", "content"};
+  Names ids = {"sidebar-ad"};
+  HiddenSelectors selectors;
+  cache.GetSelectors(ExampleOrigin(), {}, 1, &classes, &ids, &selectors);
+  EXPECT_EQ(Names({"ad", "content"}), classes);
+  EXPECT_EQ(Names({"sidebar-ad"}), ids);
+  EXPECT_EQ(3u, cache.miss_count());
+
+  HiddenSelectors ad_selectors = AdSelectors();
+  ad_selectors.hide_selectors.push_back("#sidebar-ad");
+  cache.PutSelectors(ExampleOrigin(), {}, 1, classes, ids, ad_selectors);
+
+  // Other pages of the origin only look up the names which weren't cached,
+  // including those which hide nothing.
+  classes = {"content", "ad", "footer"};
+  ids = {"sidebar-ad"};
+  selectors = HiddenSelectors();
+  cache.GetSelectors(
+      url::Origin::Create(GURL("https://example.com/other/page")), {}, 1,
+      &classes, &ids, &selectors);
+  EXPECT_EQ(Names({"footer"}), classes);
+  EXPECT_TRUE(ids.empty());
+  EXPECT_EQ(Names({".ad", ".ad > .banner", "#sidebar-ad"}),
+            selectors.hide_selectors);
+  EXPECT_EQ(Names({".ad:not(.wide)"}), selectors.force_hide_selectors);
+  EXPECT_EQ(3u, cache.hit_count());
+  EXPECT_EQ(4u, cache.miss_count());
+}
+
+TEST(AdBlockSelectorCacheTest, KeyedOnOriginAndExceptions) {
+  AdBlockSelectorCache cache;
+  cache.PutSelectors(ExampleOrigin(), {".ad"}, 1, {"ad"}, {}, AdSelectors());
+
+  Names classes = {"ad"};
+  Names ids;
+  HiddenSelectors selectors;
+  cache.GetSelectors(url::Origin::Create(GURL("https://other.com/")), {".ad"},
+                     1, &classes, &ids, &selectors);
+  EXPECT_EQ(Names({"ad"}), classes);
+
+  cache.GetSelectors(ExampleOrigin(), {}, 1, &classes, &ids, &selectors);
+  EXPECT_EQ(Names({"ad"}), classes);
+  EXPECT_TRUE(selectors.hide_selectors.empty());
+
+  // Opaque origins are never cached.
+  const url::Origin opaque;
+  cache.PutSelectors(opaque, {}, 1, {"ad"}, {}, AdSelectors());
+  cache.GetSelectors(opaque, {}, 1, &classes, &ids, &selectors);
+  EXPECT_EQ(Names({"ad"}), classes);
+  EXPECT_EQ(0u, cache.hit_count());
+
+  cache.GetSelectors(ExampleOrigin(), {".ad"}, 1, &classes, &ids, &selectors);
+  EXPECT_TRUE(classes.empty());
+  EXPECT_EQ(1u, cache.hit_count());
+}
+
+TEST(AdBlockSelectorCacheTest, SkipsBatchesWhichCantBeAttributed) {
+  AdBlockSelectorCache cache;
+  HiddenSelectors selectors;
+  // Neither selector starts with a name from the batch.
+  selectors.hide_selectors = {".ad", "div.ad"};
+  cache.PutSelectors(ExampleOrigin(), {}, 1, {"ad"}, {}, selectors);
+  selectors.hide_selectors = {".ad", ".advert"};
+  cache.PutSelectors(ExampleOrigin(), {}, 1, {"ad"}, {}, selectors);
+
+  Names classes = {"ad"};
+  Names ids;
+  HiddenSelectors cached;
+  cache.GetSelectors(ExampleOrigin(), {}, 1, &classes, &ids, &cached);
+  EXPECT_EQ(Names({"ad"}), classes);
+  EXPECT_TRUE(cached.hide_selectors.empty());
+}
+
+TEST(AdBlockSelectorCacheTest, InvalidatedByGenerationChange) {
+  AdBlockSelectorCache cache;
+  cache.PutSelectors(ExampleOrigin(), {}, 1, {"ad"}, {}, AdSelectors());
+
+  Names classes = {"ad"};
+  Names ids;
+  HiddenSelectors selectors;
+  cache.GetSelectors(ExampleOrigin(), {}, 2, &classes, &ids, &selectors);
+  EXPECT_EQ(Names({"ad"}), classes);
+
+  // Selectors matched against an older generation are dropped.
+  cache.PutSelectors(ExampleOrigin(), {}, 1, {"ad"}, {}, AdSelectors());
+  cache.GetSelectors(ExampleOrigin(), {}, 2, &classes, &ids, &selectors);
+  EXPECT_EQ(Names({"ad"}), classes);
+  EXPECT_EQ(0u, cache.hit_count());
+
+  cache.PutSelectors(ExampleOrigin(), {}, 2, {"ad"}, {}, AdSelectors());
+  cache.GetSelectors(ExampleOrigin(), {}, 2, &classes, &ids, &selectors);
+  EXPECT_TRUE(classes.empty());
+}
+
+TEST(AdBlockSelectorCacheTest, EvictsLeastRecentlyUsedOrigin) {
+  AdBlockSelectorCache cache(1);
+  cache.PutSelectors(ExampleOrigin(), {}, 1, {"ad"}, {}, AdSelectors());
+  cache.PutSelectors(url::Origin::Create(GURL("https://other.com/")), {}, 1,
+                     {"ad"}, {}, AdSelectors());
+
+  Names classes = {"ad"};
+  Names ids;
+  HiddenSelectors selectors;
+  cache.GetSelectors(ExampleOrigin(), {}, 1, &classes, &ids, &selectors);
+  EXPECT_EQ(Names({"ad"}), classes);
+  cache.GetSelectors(url::Origin::Create(GURL("https://other.com/")), {}, 1,
+                     &classes, &ids, &selectors);
+  EXPECT_TRUE(classes.empty());
+}
+
+}  // namespace brave_shields
@@ -18,11 +18,14 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
 #include "brave/components/brave_shields/browser/ad_block_component_filters_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_custom_filters_provider.h"
+#include "brave/components/brave_shields/browser/ad_block_decision_cache.h"
 #include "brave/components/brave_shields/browser/ad_block_default_resource_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_engine.h"
 #include "brave/components/brave_shields/browser/ad_block_filter_list_catalog_provider.h"
+#include "brave/components/brave_shields/browser/ad_block_merged_engine_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_service_manager.h"
@@ -39,6 +42,7 @@
 
 namespace {
 
+const char kCustomFiltersListId[] = "custom_filters";
 const char kAdBlockComponentName[] = "Brave Ad Block Updater";
 const char kAdBlockComponentId[] = "iodkpdagapdfkphljnddpjlldadblomo";
 const char kAdBlockComponentBase64PublicKey[] =
@@ -54,6 +58,39 @@ std::string g_ad_block_component_id_(kAdBlockComponentId);
 std::string g_ad_block_component_base64_public_key_(
     kAdBlockComponentBase64PublicKey);
 
+// Merges the matches of a request against |engine_count| engines, where the
+// engine at index 0 is the default engine. |match_engine| is called with the
+// index of each engine and the URL to match against it. The default engine
+// is skipped for first-party requests unless blocking aggressively. Each
+// engine matches the URL as rewritten by the engines before it, and matching
+// stops at the first important rule.
+template <typename MatchEngine>
+void MergeShouldStartRequest(const GURL& url,
+                             const std::string& tab_host,
+                             bool aggressive_blocking,
+                             size_t engine_count,
+                             bool* did_match_important,
+                             std::string* rewritten_url,
+                             MatchEngine match_engine) {
+  for (size_t i = 0; i < engine_count; ++i) {
+    if (i == 0 && !aggressive_blocking &&
+        !base::FeatureList::IsEnabled(
+            brave_shields::features::kBraveAdblockDefault1pBlocking) &&
+        SameDomainOrHost(
+            url, url::Origin::CreateFromNormalizedTuple("https", tab_host, 80),
+            net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES)) {
+      continue;
+    }
+
+    const GURL request_url =
+        rewritten_url && !rewritten_url->empty() ? GURL(*rewritten_url) : url;
+    match_engine(i, request_url);
+    if (did_match_important && *did_match_important) {
+      return;
+    }
+  }
+}
+
 }  // namespace
 
 namespace brave_shields {
@@ -64,11 +101,15 @@ AdBlockService::SourceProviderObserver::SourceProviderObserver(
     AdBlockResourceProvider* resource_provider,
     scoped_refptr<base::SequencedTaskRunner> task_runner,
     base::RepeatingCallback<void(const adblock::FilterListMetadata&)>
-        on_metadata_retrieved)
+        on_metadata_retrieved,
+    base::RepeatingCallback<void(bool deserialize,
+                                 const DATFileDataBuffer& dat_buf)>
+        on_filters_loaded)
     : adblock_engine_(adblock_engine),
       filters_provider_(filters_provider),
       resource_provider_(resource_provider),
       on_metadata_retrieved_(on_metadata_retrieved),
+      on_filters_loaded_(on_filters_loaded),
       task_runner_(task_runner) {
   filters_provider_->AddObserver(this);
   filters_provider_->LoadDAT(this);
@@ -82,6 +123,7 @@ AdBlockService::SourceProviderObserver::~SourceProviderObserver() {
 void AdBlockService::SourceProviderObserver::OnDATLoaded(
     bool deserialize,
     const DATFileDataBuffer& dat_buf) {
+  on_filters_loaded_.Run(deserialize, dat_buf);
   deserialize_ = deserialize;
   dat_buf_ = std::move(dat_buf);
   // multiple AddObserver calls are ignored
@@ -125,6 +167,42 @@ void AdBlockService::SourceProviderObserver::OnEngineReplaced(
   }
 }
 
+AdBlockService::EngineSnapshots::EngineSnapshots() = default;
+
+AdBlockService::EngineSnapshots::EngineSnapshots(EngineSnapshots&&) = default;
+
+AdBlockService::EngineSnapshots& AdBlockService::EngineSnapshots::operator=(
+    EngineSnapshots&&) = default;
+
+AdBlockService::EngineSnapshots::~EngineSnapshots() = default;
+
+void AdBlockService::EngineSnapshots::ShouldStartRequest(
+    const GURL& url,
+    blink::mojom::ResourceType resource_type,
+    const std::string& tab_host,
+    bool aggressive_blocking,
+    bool* did_match_rule,
+    bool* did_match_exception,
+    bool* did_match_important,
+    std::string* mock_data_url,
+    std::string* rewritten_url) const {
+  MergeShouldStartRequest(
+      url, tab_host, aggressive_blocking, additional_engines_.size() + 1,
+      did_match_important, rewritten_url,
+      [&](size_t index, const GURL& request_url) {
+        AdBlockEngineSnapshot* engine =
+            index == 0 ? default_engine_.get()
+                       : additional_engines_[index - 1].get();
+        if (!engine) {
+          return;
+        }
+        engine->ShouldStartRequest(request_url, resource_type, tab_host,
+                                   aggressive_blocking, did_match_rule,
+                                   did_match_exception, did_match_important,
+                                   mock_data_url, rewritten_url);
+      });
+}
+
 void AdBlockService::ShouldStartRequest(
     const GURL& url,
     blink::mojom::ResourceType resource_type,
@@ -137,48 +215,46 @@ void AdBlockService::ShouldStartRequest(
     std::string* rewritten_url) {
   DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
 
-  GURL request_url;
-
-  if (aggressive_blocking ||
-      base::FeatureList::IsEnabled(
-          brave_shields::features::kBraveAdblockDefault1pBlocking) ||
-      !SameDomainOrHost(
-          url, url::Origin::CreateFromNormalizedTuple("https", tab_host, 80),
-          net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES)) {
-    request_url =
-        rewritten_url && !rewritten_url->empty() ? GURL(*rewritten_url) : url;
-    default_service()->ShouldStartRequest(
-        request_url, resource_type, tab_host, aggressive_blocking,
-        did_match_rule, did_match_exception, did_match_important, mock_data_url,
-        rewritten_url);
-    if (did_match_important && *did_match_important) {
-      return;
-    }
-  }
-
-  request_url =
-      rewritten_url && !rewritten_url->empty() ? GURL(*rewritten_url) : url;
-  regional_service_manager()->ShouldStartRequest(
-      request_url, resource_type, tab_host, aggressive_blocking, did_match_rule,
-      did_match_exception, did_match_important, mock_data_url, rewritten_url);
-  if (did_match_important && *did_match_important) {
+  // Only fresh queries are cached, not ones which continue an earlier match,
+  // like the check of a CNAME-uncloaked request.
+  if (!decision_cache_ || !did_match_rule || !did_match_exception ||
+      !did_match_important || !mock_data_url || !rewritten_url ||
+      *did_match_rule || *did_match_exception || *did_match_important ||
+      !mock_data_url->empty() || !rewritten_url->empty()) {
+    ShouldStartRequestUncached(url, resource_type, tab_host,
+                               aggressive_blocking, did_match_rule,
+                               did_match_exception, did_match_important,
+                               mock_data_url, rewritten_url);
     return;
   }
 
-  request_url =
-      rewritten_url && !rewritten_url->empty() ? GURL(*rewritten_url) : url;
-  subscription_service_manager()->ShouldStartRequest(
-      request_url, resource_type, tab_host, aggressive_blocking, did_match_rule,
-      did_match_exception, did_match_important, mock_data_url, rewritten_url);
-  if (did_match_important && *did_match_important) {
+  const uint64_t generation = AdBlockEngine::GetGeneration();
+  if (auto decision = decision_cache_->GetDecision(
+          url, resource_type, tab_host, aggressive_blocking, generation)) {
+    *did_match_rule = decision->did_match_rule;
+    *did_match_exception = decision->did_match_exception;
+    *did_match_important = decision->did_match_important;
+    *mock_data_url = std::move(decision->mock_data_url);
+    *rewritten_url = std::move(decision->rewritten_url);
     return;
   }
 
-  request_url =
-      rewritten_url && !rewritten_url->empty() ? GURL(*rewritten_url) : url;
-  custom_filters_service()->ShouldStartRequest(
-      request_url, resource_type, tab_host, aggressive_blocking, did_match_rule,
-      did_match_exception, did_match_important, mock_data_url, rewritten_url);
+  const base::TimeTicks start_time = base::TimeTicks::Now();
+  ShouldStartRequestUncached(url, resource_type, tab_host, aggressive_blocking,
+                             did_match_rule, did_match_exception,
+                             did_match_important, mock_data_url, rewritten_url);
+
+  AdBlockDecisionCache::Decision decision;
+  decision.did_match_rule = *did_match_rule;
+  decision.did_match_exception = *did_match_exception;
+  decision.did_match_important = *did_match_important;
+  decision.mock_data_url = *mock_data_url;
+  decision.rewritten_url = *rewritten_url;
+  decision.match_time = base::TimeTicks::Now() - start_time;
+  // If an engine changed while matching, |generation| is already stale and
+  // the decision will be dropped on the next lookup.
+  decision_cache_->PutDecision(url, resource_type, tab_host,
+                               aggressive_blocking, generation, decision);
 }
 
 absl::optional<std::string> AdBlockService::GetCspDirectives(
@@ -186,9 +262,91 @@ absl::optional<std::string> AdBlockService::GetCspDirectives(
     blink::mojom::ResourceType resource_type,
     const std::string& tab_host) {
   DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+
+  if (!decision_cache_) {
+    return GetCspDirectivesUncached(url, resource_type, tab_host);
+  }
+
+  const uint64_t generation = AdBlockEngine::GetGeneration();
+  if (auto csp_directives = decision_cache_->GetCspDirectives(
+          url, resource_type, tab_host, generation)) {
+    return *csp_directives;
+  }
+
+  auto csp_directives = GetCspDirectivesUncached(url, resource_type, tab_host);
+  decision_cache_->PutCspDirectives(url, resource_type, tab_host, generation,
+                                    csp_directives);
+  return csp_directives;
+}
+
+void AdBlockService::ShouldStartRequestUncached(
+    const GURL& url,
+    blink::mojom::ResourceType resource_type,
+    const std::string& tab_host,
+    bool aggressive_blocking,
+    bool* did_match_rule,
+    bool* did_match_exception,
+    bool* did_match_important,
+    std::string* mock_data_url,
+    std::string* rewritten_url) {
+  // The merged engine, when loaded, replaces the regional, subscription and
+  // custom filter engines.
+  AdBlockEngine* merged_engine = GetMergedEngineIfLoaded();
+
+  MergeShouldStartRequest(
+      url, tab_host, aggressive_blocking, merged_engine ? 2 : 4,
+      did_match_important, rewritten_url,
+      [&](size_t index, const GURL& request_url) {
+        switch (index) {
+          case 0:
+            default_service()->ShouldStartRequest(
+                request_url, resource_type, tab_host, aggressive_blocking,
+                did_match_rule, did_match_exception, did_match_important,
+                mock_data_url, rewritten_url);
+            break;
+          case 1:
+            if (merged_engine) {
+              merged_engine->ShouldStartRequest(
+                  request_url, resource_type, tab_host, aggressive_blocking,
+                  did_match_rule, did_match_exception, did_match_important,
+                  mock_data_url, rewritten_url);
+            } else {
+              regional_service_manager()->ShouldStartRequest(
+                  request_url, resource_type, tab_host, aggressive_blocking,
+                  did_match_rule, did_match_exception, did_match_important,
+                  mock_data_url, rewritten_url);
+            }
+            break;
+          case 2:
+            subscription_service_manager()->ShouldStartRequest(
+                request_url, resource_type, tab_host, aggressive_blocking,
+                did_match_rule, did_match_exception, did_match_important,
+                mock_data_url, rewritten_url);
+            break;
+          case 3:
+            custom_filters_service()->ShouldStartRequest(
+                request_url, resource_type, tab_host, aggressive_blocking,
+                did_match_rule, did_match_exception, did_match_important,
+                mock_data_url, rewritten_url);
+            break;
+        }
+      });
+}
+
+absl::optional<std::string> AdBlockService::GetCspDirectivesUncached(
+    const GURL& url,
+    blink::mojom::ResourceType resource_type,
+    const std::string& tab_host) {
   auto csp_directives =
       default_service()->GetCspDirectives(url, resource_type, tab_host);
 
+  if (AdBlockEngine* merged_engine = GetMergedEngineIfLoaded()) {
+    const auto merged_csp =
+        merged_engine->GetCspDirectives(url, resource_type, tab_host);
+    MergeCspDirectiveInto(merged_csp, &csp_directives);
+    return csp_directives;
+  }
+
   const auto regional_csp = regional_service_manager()->GetCspDirectives(
       url, resource_type, tab_host);
   MergeCspDirectiveInto(regional_csp, &csp_directives);
@@ -210,6 +368,19 @@ absl::optional<base::Value> AdBlockService::UrlCosmeticResources(
     return resources;
   }
 
+  if (AdBlockEngine* merged_engine = GetMergedEngineIfLoaded()) {
+    absl::optional<base::Value> merged_resources =
+        merged_engine->UrlCosmeticResources(url);
+
+    if (merged_resources && merged_resources->is_dict()) {
+      MergeResourcesInto(std::move(merged_resources->GetDict()),
+                         resources->GetIfDict(),
+                         /*force_hide=*/true);
+    }
+
+    return resources;
+  }
+
   absl::optional<base::Value> regional_resources =
       regional_service_manager()->UrlCosmeticResources(url);
 
@@ -240,47 +411,71 @@ absl::optional<base::Value> AdBlockService::UrlCosmeticResources(
   return resources;
 }
 
-// The return value here is formatted differently from the rest of the adblock
-// service instances. We need to distinguish between selectors returned from
-// the default engine and those returned by other engines, but still comply
-// with the virtual method signature.
-// This can be improved once interfaces are decoupled in
-// https://github.com/brave/brave-core/pull/10994.
-// For now, this returns a dict with two properties:
-//  - "hide_selectors" - wraps the result from the default engine
-//  - "force_hide_selectors" - wraps appended results from all other engines
-base::Value::Dict AdBlockService::HiddenClassIdSelectors(
+HiddenSelectors AdBlockService::HiddenClassIdSelectors(
+    const url::Origin& origin,
     const std::vector<std::string>& classes,
     const std::vector<std::string>& ids,
     const std::vector<std::string>& exceptions) {
   DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
-  base::Value::List hide_selectors =
-      default_service()->HiddenClassIdSelectors(classes, ids, exceptions);
 
-  base::Value::List regional_selectors =
-      regional_service_manager()->HiddenClassIdSelectors(classes, ids,
-                                                         exceptions);
+  if (!selector_cache_) {
+    return HiddenClassIdSelectorsUncached(classes, ids, exceptions);
+  }
 
-  base::Value::List custom_selectors =
-      custom_filters_service()->HiddenClassIdSelectors(classes, ids,
-                                                       exceptions);
-  base::Value::List subscription_selectors =
-      subscription_service_manager()->HiddenClassIdSelectors(classes, ids,
-                                                             exceptions);
+  const uint64_t generation = AdBlockEngine::GetGeneration();
+  HiddenSelectors selectors;
+  std::vector<std::string> uncached_classes(classes);
+  std::vector<std::string> uncached_ids(ids);
+  selector_cache_->GetSelectors(origin, exceptions, generation,
+                                &uncached_classes, &uncached_ids, &selectors);
+  if (uncached_classes.empty() && uncached_ids.empty()) {
+    return selectors;
+  }
 
-  base::Value::List force_hide_selectors = std::move(regional_selectors);
+  HiddenSelectors uncached_selectors = HiddenClassIdSelectorsUncached(
+      uncached_classes, uncached_ids, exceptions);
+  selector_cache_->PutSelectors(origin, exceptions, generation,
+                                uncached_classes, uncached_ids,
+                                uncached_selectors);
+  selectors.Append(uncached_selectors);
+  return selectors;
+}
 
-  for (auto& custom_selector : custom_selectors) {
-    force_hide_selectors.Append(std::move(custom_selector));
-  }
+// Selectors from the default engine are kept apart from those of all other
+// engines, which also apply to first party content.
+HiddenSelectors AdBlockService::HiddenClassIdSelectorsUncached(
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
+    const std::vector<std::string>& exceptions) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  HiddenSelectors result;
+  auto append = [](base::Value::List selectors,
+                   std::vector<std::string>* list) {
+    for (auto& selector : selectors) {
+      if (std::string* selector_string = selector.GetIfString()) {
+        list->push_back(std::move(*selector_string));
+      }
+    }
+  };
 
-  for (auto& subscription_selector : subscription_selectors) {
-    force_hide_selectors.Append(std::move(subscription_selector));
+  append(default_service()->HiddenClassIdSelectors(classes, ids, exceptions),
+         &result.hide_selectors);
+
+  if (AdBlockEngine* merged_engine = GetMergedEngineIfLoaded()) {
+    append(merged_engine->HiddenClassIdSelectors(classes, ids, exceptions),
+           &result.force_hide_selectors);
+    return result;
   }
 
-  base::Value::Dict result;
-  result.Set("hide_selectors", std::move(hide_selectors));
-  result.Set("force_hide_selectors", std::move(force_hide_selectors));
+  append(regional_service_manager()->HiddenClassIdSelectors(classes, ids,
+                                                            exceptions),
+         &result.force_hide_selectors);
+  append(custom_filters_service()->HiddenClassIdSelectors(classes, ids,
+                                                          exceptions),
+         &result.force_hide_selectors);
+  append(subscription_service_manager()->HiddenClassIdSelectors(classes, ids,
+                                                                exceptions),
+         &result.force_hide_selectors);
   return result;
 }
 
@@ -290,7 +485,8 @@ AdBlockRegionalServiceManager* AdBlockService::regional_service_manager() {
         brave_shields::AdBlockRegionalServiceManagerFactory(
             local_state_, locale_, component_update_service_, GetTaskRunner());
     regional_service_manager_->Init(resource_provider_.get(),
-                                    filter_list_catalog_provider_.get());
+                                    filter_list_catalog_provider_.get(),
+                                    merged_engine_manager());
   }
   return regional_service_manager_.get();
 }
@@ -312,9 +508,17 @@ AdBlockEngine* AdBlockService::custom_filters_service() {
     custom_filters_service_ =
         std::unique_ptr<AdBlockEngine, base::OnTaskRunnerDeleter>(
             new AdBlockEngine(), base::OnTaskRunnerDeleter(GetTaskRunner()));
+    base::RepeatingCallback<void(bool, const DATFileDataBuffer&)>
+        on_filters_loaded = base::DoNothing();
+    if (merged_engine_manager()) {
+      on_filters_loaded = base::BindRepeating(
+          &AdBlockMergedEngineManager::SetList,
+          merged_engine_manager()->AsWeakPtr(), kCustomFiltersListId);
+    }
     custom_filters_service_observer_ = std::make_unique<SourceProviderObserver>(
         custom_filters_service_->AsWeakPtr(), custom_filters_provider_.get(),
-        resource_provider_.get(), GetTaskRunner());
+        resource_provider_.get(), GetTaskRunner(), base::DoNothing(),
+        std::move(on_filters_loaded));
   }
   return custom_filters_service_.get();
 }
@@ -327,11 +531,22 @@ AdBlockService::custom_filters_provider() {
 brave_shields::AdBlockSubscriptionServiceManager*
 AdBlockService::subscription_service_manager() {
   if (!subscription_service_manager_->IsInitialized()) {
-    subscription_service_manager_->Init(resource_provider_.get());
+    subscription_service_manager_->Init(resource_provider_.get(),
+                                        merged_engine_manager());
   }
   return subscription_service_manager_.get();
 }
 
+AdBlockMergedEngineManager* AdBlockService::merged_engine_manager() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!merged_engine_manager_ &&
+      base::FeatureList::IsEnabled(features::kBraveAdblockMergedEngine)) {
+    merged_engine_manager_ = std::make_unique<AdBlockMergedEngineManager>(
+        GetTaskRunner(), resource_provider_.get());
+  }
+  return merged_engine_manager_.get();
+}
+
 AdBlockService::AdBlockService(
     PrefService* local_state,
     std::string locale,
@@ -345,7 +560,16 @@ AdBlockService::AdBlockService(
       task_runner_(task_runner),
       custom_filters_service_(nullptr, base::OnTaskRunnerDeleter(task_runner_)),
       default_service_(nullptr, base::OnTaskRunnerDeleter(task_runner_)),
-      subscription_service_manager_(std::move(subscription_service_manager)) {
+      subscription_service_manager_(std::move(subscription_service_manager)),
+      decision_cache_(nullptr, base::OnTaskRunnerDeleter(task_runner_)),
+      selector_cache_(nullptr, base::OnTaskRunnerDeleter(task_runner_)) {
+  if (base::FeatureList::IsEnabled(features::kBraveAdblockDecisionCache)) {
+    decision_cache_.reset(new AdBlockDecisionCache());
+  }
+  if (base::FeatureList::IsEnabled(features::kBraveAdblockSelectorCache)) {
+    selector_cache_.reset(new AdBlockSelectorCache());
+  }
+
   // Initializes adblock-rust's domain resolution implementation
   adblock::SetDomainResolver(AdBlockServiceDomainResolver);
 
@@ -370,6 +594,7 @@ bool AdBlockService::Start() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   // Initialize each service:
+  merged_engine_manager();
   default_service();
   custom_filters_service();
   regional_service_manager();
@@ -380,16 +605,42 @@ bool AdBlockService::Start() {
 
 void AdBlockService::EnableTag(const std::string& tag, bool enabled) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  // Tags only need to be modified for the default engine.
+  // Tags only need to be modified for the default engine, and for the merged
+  // engine which regional lists and subscriptions are compiled into.
   GetTaskRunner()->PostTask(
       FROM_HERE, base::BindOnce(&AdBlockEngine::EnableTag,
                                 default_service()->AsWeakPtr(), tag, enabled));
+  if (merged_engine_manager()) {
+    merged_engine_manager()->EnableTag(tag, enabled);
+  }
 }
 
 base::SequencedTaskRunner* AdBlockService::GetTaskRunner() {
   return task_runner_.get();
 }
 
+AdBlockService::EngineSnapshots AdBlockService::GetEngineSnapshots() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  EngineSnapshots snapshots;
+  snapshots.default_engine_ = default_service()->GetSnapshot();
+
+  if (merged_engine_manager()) {
+    if (auto merged_engine = merged_engine_manager()->GetEngineSnapshot()) {
+      snapshots.additional_engines_.push_back(std::move(merged_engine));
+      return snapshots;
+    }
+  }
+
+  regional_service_manager()->AppendEngineSnapshots(
+      &snapshots.additional_engines_);
+  subscription_service_manager()->AppendEngineSnapshots(
+      &snapshots.additional_engines_);
+  if (auto custom_filters_engine = custom_filters_service()->GetSnapshot()) {
+    snapshots.additional_engines_.push_back(std::move(custom_filters_engine));
+  }
+  return snapshots;
+}
+
 void RegisterPrefsForAdBlockService(PrefRegistrySimple* registry) {
   registry->RegisterBooleanPref(prefs::kAdBlockCookieListOptInShown, false);
   registry->RegisterBooleanPref(prefs::kAdBlockCookieListSettingTouched, false);
@@ -403,6 +654,16 @@ AdBlockResourceProvider* AdBlockService::resource_provider() {
   return resource_provider_.get();
 }
 
+AdBlockEngine* AdBlockService::GetMergedEngineIfLoaded() {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  // |merged_engine_manager_| is created on the UI thread before any engine is
+  // loaded and is not destroyed until the service is shut down.
+  if (!merged_engine_manager_) {
+    return nullptr;
+  }
+  return merged_engine_manager_->GetEngineIfLoaded();
+}
+
 void AdBlockService::UseSourceProvidersForTest(
     AdBlockFiltersProvider* source_provider,
     AdBlockResourceProvider* resource_provider) {
@@ -13,12 +13,14 @@
 #include <vector>
 
 #include "base/memory/raw_ptr.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/values.h"
 #include "brave/components/brave_shields/browser/ad_block_filters_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_resource_provider.h"
+#include "brave/components/brave_shields/browser/ad_block_selector_cache.h"
 #include "components/keyed_service/core/keyed_service.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "content/public/browser/browser_thread.h"
@@ -35,6 +37,10 @@ class PerfPredictorTabHelperTest;
 class PrefChangeRegistrar;
 class PrefService;
 
+namespace url {
+class Origin;
+}  // namespace url
+
 namespace component_updater {
 class ComponentUpdateService;
 }  // namespace component_updater
@@ -46,11 +52,14 @@ struct FilterListMetadata;
 namespace brave_shields {
 
 class AdBlockEngine;
+class AdBlockEngineSnapshot;
 class AdBlockComponentFiltersProvider;
 class AdBlockDefaultResourceProvider;
 class AdBlockRegionalServiceManager;
 class AdBlockCustomFiltersProvider;
+class AdBlockDecisionCache;
 class AdBlockFilterListCatalogProvider;
+class AdBlockMergedEngineManager;
 class AdBlockSubscriptionServiceManager;
 
 // The brave shields service in charge of ad-block checking and init.
@@ -65,7 +74,10 @@ class AdBlockService {
         AdBlockResourceProvider* resource_provider,
         scoped_refptr<base::SequencedTaskRunner> task_runner,
         base::RepeatingCallback<void(const adblock::FilterListMetadata&)>
-            on_metadata_retrieved = base::DoNothing());
+            on_metadata_retrieved = base::DoNothing(),
+        base::RepeatingCallback<void(bool deserialize,
+                                     const DATFileDataBuffer& dat_buf)>
+            on_filters_loaded = base::DoNothing());
     SourceProviderObserver(const SourceProviderObserver&) = delete;
     SourceProviderObserver& operator=(const SourceProviderObserver&) = delete;
     ~SourceProviderObserver() override;
@@ -88,11 +100,45 @@ class AdBlockService {
     raw_ptr<AdBlockResourceProvider> resource_provider_;  // not owned
     base::RepeatingCallback<void(const adblock::FilterListMetadata&)>
         on_metadata_retrieved_;
+    base::RepeatingCallback<void(bool deserialize,
+                                 const DATFileDataBuffer& dat_buf)>
+        on_filters_loaded_;
     scoped_refptr<base::SequencedTaskRunner> task_runner_;
 
     base::WeakPtrFactory<SourceProviderObserver> weak_factory_{this};
   };
 
+  // Snapshots of the engines which network requests are matched against, for
+  // matching on any thread. Engines which reload afterwards are not affected.
+  class EngineSnapshots {
+   public:
+    EngineSnapshots();
+    EngineSnapshots(EngineSnapshots&&);
+    EngineSnapshots& operator=(EngineSnapshots&&);
+    EngineSnapshots(const EngineSnapshots&) = delete;
+    EngineSnapshots& operator=(const EngineSnapshots&) = delete;
+    ~EngineSnapshots();
+
+    // Same as AdBlockService::ShouldStartRequest.
+    void ShouldStartRequest(const GURL& url,
+                            blink::mojom::ResourceType resource_type,
+                            const std::string& tab_host,
+                            bool aggressive_blocking,
+                            bool* did_match_rule,
+                            bool* did_match_exception,
+                            bool* did_match_important,
+                            std::string* mock_data_url,
+                            std::string* rewritten_url) const;
+
+   private:
+    friend class AdBlockService;
+
+    scoped_refptr<AdBlockEngineSnapshot> default_engine_;
+    // The regional, subscription and custom filter engines, or the merged
+    // engine, in the order in which they are queried.
+    std::vector<scoped_refptr<AdBlockEngineSnapshot>> additional_engines_;
+  };
+
   explicit AdBlockService(
       PrefService* local_state,
       std::string locale,
@@ -117,7 +163,10 @@ class AdBlockService {
       blink::mojom::ResourceType resource_type,
       const std::string& tab_host);
   absl::optional<base::Value> UrlCosmeticResources(const std::string& url);
-  base::Value::Dict HiddenClassIdSelectors(
+  // Returns the selectors to hide for |classes| and |ids| on a page of
+  // |origin|, served from |selector_cache_| where possible.
+  HiddenSelectors HiddenClassIdSelectors(
+      const url::Origin& origin,
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
       const std::vector<std::string>& exceptions);
@@ -126,6 +175,8 @@ class AdBlockService {
   AdBlockEngine* custom_filters_service();
   AdBlockEngine* default_service();
   AdBlockSubscriptionServiceManager* subscription_service_manager();
+  // Returns nullptr unless merged engine mode is enabled.
+  AdBlockMergedEngineManager* merged_engine_manager();
 
   AdBlockCustomFiltersProvider* custom_filters_provider();
 
@@ -133,6 +184,10 @@ class AdBlockService {
 
   base::SequencedTaskRunner* GetTaskRunner();
 
+  // Returns snapshots of the currently loaded engines. Matching against them
+  // doesn't need to run on the task runner.
+  EngineSnapshots GetEngineSnapshots();
+
   bool Start();
 
  private:
@@ -147,6 +202,30 @@ class AdBlockService {
 
   AdBlockResourceProvider* resource_provider();
 
+  // Match against the engines without consulting |decision_cache_|.
+  void ShouldStartRequestUncached(const GURL& url,
+                                  blink::mojom::ResourceType resource_type,
+                                  const std::string& tab_host,
+                                  bool aggressive_blocking,
+                                  bool* did_match_rule,
+                                  bool* did_match_exception,
+                                  bool* did_match_important,
+                                  std::string* mock_data_url,
+                                  std::string* rewritten_url);
+  absl::optional<std::string> GetCspDirectivesUncached(
+      const GURL& url,
+      blink::mojom::ResourceType resource_type,
+      const std::string& tab_host);
+  HiddenSelectors HiddenClassIdSelectorsUncached(
+      const std::vector<std::string>& classes,
+      const std::vector<std::string>& ids,
+      const std::vector<std::string>& exceptions);
+
+  // Returns the merged engine for the regional lists, subscriptions and custom
+  // filters, or nullptr if merged engine mode is disabled or the engine has not
+  // been compiled yet. Must be called on the task runner.
+  AdBlockEngine* GetMergedEngineIfLoaded();
+
   void UseSourceProvidersForTest(AdBlockFiltersProvider* source_provider,
                                  AdBlockResourceProvider* resource_provider);
   void UseCustomSourceProvidersForTest(
@@ -178,6 +257,16 @@ class AdBlockService {
       default_service_;
   std::unique_ptr<brave_shields::AdBlockSubscriptionServiceManager>
       subscription_service_manager_;
+  std::unique_ptr<brave_shields::AdBlockMergedEngineManager>
+      merged_engine_manager_;
+  // Only set when the decision cache is enabled. Used on the task runner.
+  std::unique_ptr<brave_shields::AdBlockDecisionCache,
+                  base::OnTaskRunnerDeleter>
+      decision_cache_;
+  // Only set when the selector cache is enabled. Used on the task runner.
+  std::unique_ptr<brave_shields::AdBlockSelectorCache,
+                  base::OnTaskRunnerDeleter>
+      selector_cache_;
 
   std::unique_ptr<SourceProviderObserver> default_service_observer_;
   std::unique_ptr<SourceProviderObserver> custom_filters_service_observer_;
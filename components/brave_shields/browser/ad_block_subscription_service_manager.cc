@@ -11,6 +11,7 @@
 
 #include "base/base64url.h"
 #include "base/bind.h"
+#include "base/callback_helpers.h"
 #include "base/containers/contains.h"
 #include "base/files/file_util.h"
 #include "base/json/json_value_converter.h"
@@ -22,6 +23,7 @@
 #include "base/values.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_shields/browser/ad_block_engine.h"
+#include "brave/components/brave_shields/browser/ad_block_merged_engine_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_filters_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_service_manager_observer.h"
@@ -127,8 +129,10 @@ AdBlockSubscriptionServiceManager::AdBlockSubscriptionServiceManager(
 }
 
 void AdBlockSubscriptionServiceManager::Init(
-    AdBlockResourceProvider* resource_provider) {
+    AdBlockResourceProvider* resource_provider,
+    AdBlockMergedEngineManager* merged_engine_manager) {
   resource_provider_ = resource_provider;
+  merged_engine_manager_ = merged_engine_manager;
   initialized_ = true;
 }
 
@@ -244,7 +248,8 @@ void AdBlockSubscriptionServiceManager::CreateSubscription(
       subscription_service->AsWeakPtr(), subscription_filters_provider.get(),
       resource_provider_, task_runner_,
       base::BindRepeating(&AdBlockSubscriptionServiceManager::OnListMetadata,
-                          weak_ptr_factory_.GetWeakPtr(), sub_url));
+                          weak_ptr_factory_.GetWeakPtr(), sub_url),
+      GetOnFiltersLoadedCallback(sub_url));
 
   {
     base::AutoLock lock(subscription_services_lock_);
@@ -291,6 +296,13 @@ void AdBlockSubscriptionServiceManager::EnableSubscription(const GURL& sub_url,
   info->enabled = enabled;
 
   UpdateSubscriptionPrefs(sub_url, *info);
+  // Disabled subscriptions are skipped rather than removed, so their engine
+  // doesn't change.
+  AdBlockEngine::IncrementGeneration();
+
+  if (merged_engine_manager_) {
+    merged_engine_manager_->SetListEnabled(sub_url.spec(), enabled);
+  }
 }
 
 void AdBlockSubscriptionServiceManager::DeleteSubscription(
@@ -310,6 +322,10 @@ void AdBlockSubscriptionServiceManager::DeleteSubscription(
   }
   ClearSubscriptionPrefs(sub_url);
 
+  if (merged_engine_manager_) {
+    merged_engine_manager_->RemoveList(sub_url.spec());
+  }
+
   base::ThreadPool::PostTask(
       FROM_HERE,
       {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
@@ -350,6 +366,19 @@ void AdBlockSubscriptionServiceManager::OnGetDownloadManager(
       base::DoNothing());
 }
 
+base::RepeatingCallback<void(bool deserialize,
+                             const DATFileDataBuffer& dat_buf)>
+AdBlockSubscriptionServiceManager::GetOnFiltersLoadedCallback(
+    const GURL& sub_url) {
+  if (!merged_engine_manager_) {
+    return base::DoNothing();
+  }
+
+  return base::BindRepeating(&AdBlockMergedEngineManager::SetList,
+                             merged_engine_manager_->AsWeakPtr(),
+                             sub_url.spec());
+}
+
 void AdBlockSubscriptionServiceManager::OnListMetadata(
     const GURL& sub_url,
     const adblock::FilterListMetadata& metadata) {
@@ -439,7 +468,12 @@ void AdBlockSubscriptionServiceManager::LoadSubscriptionServices() {
           subscription_filters_provider.get(), resource_provider_, task_runner_,
           base::BindRepeating(
               &AdBlockSubscriptionServiceManager::OnListMetadata,
-              weak_ptr_factory_.GetWeakPtr(), sub_url));
+              weak_ptr_factory_.GetWeakPtr(), sub_url),
+          GetOnFiltersLoadedCallback(sub_url));
+
+      if (merged_engine_manager_) {
+        merged_engine_manager_->SetListEnabled(sub_url.spec(), info.enabled);
+      }
 
       subscription_services_.insert(
           std::make_pair(sub_url, std::move(subscription_service)));
@@ -533,6 +567,20 @@ void AdBlockSubscriptionServiceManager::ShouldStartRequest(
   }
 }
 
+void AdBlockSubscriptionServiceManager::AppendEngineSnapshots(
+    std::vector<scoped_refptr<AdBlockEngineSnapshot>>* snapshots) {
+  base::AutoLock lock(subscription_services_lock_);
+
+  for (const auto& subscription_service : subscription_services_) {
+    auto info = GetInfo(subscriptions_, subscription_service.first);
+    if (info && info->enabled) {
+      if (auto snapshot = subscription_service.second->GetSnapshot()) {
+        snapshots->push_back(std::move(snapshot));
+      }
+    }
+  }
+}
+
 void AdBlockSubscriptionServiceManager::EnableTag(const std::string& tag,
                                                   bool enabled) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
@@ -13,6 +13,7 @@
 
 #include "base/files/file_path.h"
 #include "base/memory/raw_ptr.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/one_shot_event.h"
 #include "base/sequence_checker.h"
@@ -36,6 +37,7 @@ class JSONValueConverter;
 }
 
 namespace brave_shields {
+class AdBlockMergedEngineManager;
 class AdBlockResourceProvider;
 class AdBlockSubscriptionServiceManagerObserver;
 class AdBlockSubscriptionFiltersProvider;
@@ -105,6 +107,10 @@ class AdBlockSubscriptionServiceManager {
                           bool* did_match_important,
                           std::string* mock_data_url,
                           std::string* rewritten_url);
+  // Appends snapshots of the loaded engines, in the order in which
+  // ShouldStartRequest queries them.
+  void AppendEngineSnapshots(
+      std::vector<scoped_refptr<AdBlockEngineSnapshot>>* snapshots);
   void EnableTag(const std::string& tag, bool enabled);
   void AddResources(const std::string& resources);
 
@@ -124,7 +130,8 @@ class AdBlockSubscriptionServiceManager {
   void AddObserver(AdBlockSubscriptionServiceManagerObserver* observer);
   void RemoveObserver(AdBlockSubscriptionServiceManagerObserver* observer);
 
-  void Init(AdBlockResourceProvider* resource_provider);
+  void Init(AdBlockResourceProvider* resource_provider,
+            AdBlockMergedEngineManager* merged_engine_manager);
   bool IsInitialized();
 
  private:
@@ -146,6 +153,10 @@ class AdBlockSubscriptionServiceManager {
   void OnGetDownloadManager(
       AdBlockSubscriptionDownloadManager* download_manager);
 
+  base::RepeatingCallback<void(bool deserialize,
+                               const DATFileDataBuffer& dat_buf)>
+  GetOnFiltersLoadedCallback(const GURL& sub_url);
+
   void OnListMetadata(const GURL& sub_url,
                       const adblock::FilterListMetadata& metadata);
 
@@ -161,6 +172,7 @@ class AdBlockSubscriptionServiceManager {
   raw_ptr<PrefService> local_state_ GUARDED_BY_CONTEXT(sequence_checker_);
   scoped_refptr<base::SequencedTaskRunner> task_runner_;
   raw_ptr<AdBlockResourceProvider> resource_provider_;
+  raw_ptr<AdBlockMergedEngineManager> merged_engine_manager_ = nullptr;
   raw_ptr<brave_component_updater::BraveComponent::Delegate>
       delegate_;  // NOT OWNED
   base::WeakPtr<AdBlockSubscriptionDownloadManager> download_manager_;
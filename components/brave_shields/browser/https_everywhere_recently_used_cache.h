@@ -30,6 +30,11 @@ template <class T> class HTTPSERecentlyUsedCache {
     return false;
   }
 
+  void clear() {
+    base::AutoLock lock(lock_);
+    data_.Clear();
+  }
+
   void remove(const std::string& key) {
     base::AutoLock lock(lock_);
     auto it = data_.Peek(key);
@@ -0,0 +1,238 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_ruleset.h"
+
+#include <utility>
+
+#include "base/json/json_reader.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "third_party/re2/src/re2/re2.h"
+#include "third_party/re2/src/re2/set.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr char kWildcardSuffix[] = ".*";
+
+// HTTPS Everywhere rules use $1 for their groups, where RE2 uses \1.
+std::string CorrectRuleForRE2(const std::string& rule) {
+  std::string corrected;
+  base::ReplaceChars(rule, "$", "\\", &corrected);
+  return corrected;
+}
+
+}  // namespace
+
+struct HTTPSEverywhereRuleset::Ruleset {
+  struct Rule {
+    // Unset for rules which upgrade any URL they are reached for.
+    absl::optional<std::string> from;
+    std::string to;
+    std::unique_ptr<re2::RE2> from_regex;
+  };
+
+  struct Group {
+    std::vector<std::string> exclusions;
+    std::unique_ptr<re2::RE2::Set> exclusion_set;
+    // False if the group has no list of rules, which ends the lookup.
+    bool has_rules = false;
+    std::vector<Rule> rules;
+  };
+
+  void Compile() {
+    for (Group& group : groups) {
+      if (!group.exclusions.empty()) {
+        auto exclusion_set = std::make_unique<re2::RE2::Set>(
+            re2::RE2::Options(), re2::RE2::ANCHOR_BOTH);
+        bool has_exclusions = false;
+        for (const std::string& exclusion : group.exclusions) {
+          has_exclusions |= exclusion_set->Add(exclusion, nullptr) >= 0;
+        }
+        if (has_exclusions && exclusion_set->Compile()) {
+          group.exclusion_set = std::move(exclusion_set);
+        }
+      }
+      for (Rule& rule : group.rules) {
+        if (rule.from) {
+          rule.from_regex = std::make_unique<re2::RE2>(*rule.from);
+        }
+      }
+    }
+    compiled = true;
+  }
+
+  std::vector<Group> groups;
+  bool compiled = false;
+};
+
+HTTPSEverywhereRuleset::Node::Node() = default;
+HTTPSEverywhereRuleset::Node::Node(Node&&) = default;
+HTTPSEverywhereRuleset::Node& HTTPSEverywhereRuleset::Node::operator=(Node&&) =
+    default;
+HTTPSEverywhereRuleset::Node::~Node() = default;
+
+HTTPSEverywhereRuleset::HTTPSEverywhereRuleset() : nodes_(1) {}
+
+HTTPSEverywhereRuleset::~HTTPSEverywhereRuleset() = default;
+
+bool HTTPSEverywhereRuleset::AddRules(base::StringPiece key,
+                                      base::StringPiece rules_json) {
+  absl::optional<base::Value> json_object = base::JSONReader::Read(rules_json);
+  if (key.empty() || !json_object || !json_object->is_list()) {
+    return false;
+  }
+
+  auto ruleset = std::make_unique<Ruleset>();
+  for (const auto& top_value : json_object->GetList()) {
+    const base::Value::Dict* top_dict = top_value.GetIfDict();
+    if (!top_dict) {
+      continue;
+    }
+    Ruleset::Group& group = ruleset->groups.emplace_back();
+
+    if (const base::Value::List* exclusions = top_dict->FindList("e")) {
+      for (const auto& exclusion : *exclusions) {
+        const base::Value::Dict* exclusion_dict = exclusion.GetIfDict();
+        const std::string* pattern =
+            exclusion_dict ? exclusion_dict->FindString("p") : nullptr;
+        if (pattern) {
+          group.exclusions.push_back(CorrectRuleForRE2(*pattern));
+        }
+      }
+    }
+
+    const base::Value::List* rules = top_dict->FindList("r");
+    if (!rules) {
+      // Nothing after a group without rules is ever reached.
+      break;
+    }
+    group.has_rules = true;
+    for (const auto& rule_value : *rules) {
+      const base::Value::Dict* rule_dict = rule_value.GetIfDict();
+      if (!rule_dict) {
+        continue;
+      }
+      if (rule_dict->Find("d")) {
+        group.rules.emplace_back();
+        // Nothing after a default rule is ever reached either.
+        break;
+      }
+      const std::string* from = rule_dict->FindString("f");
+      const std::string* to = rule_dict->FindString("t");
+      if (!from || !to) {
+        continue;
+      }
+      Ruleset::Rule& rule = group.rules.emplace_back();
+      rule.from = *from;
+      rule.to = CorrectRuleForRE2(*to);
+    }
+  }
+
+  // Keys are hosts with their labels reversed, so walk them from the front.
+  const bool is_wildcard = base::EndsWith(key, kWildcardSuffix);
+  if (is_wildcard) {
+    key.remove_suffix(sizeof(kWildcardSuffix) - 1);
+  }
+  uint32_t node_index = 0;
+  for (const base::StringPiece label : base::SplitStringPiece(
+           key, ".", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL)) {
+    auto it = nodes_[node_index].children.find(label);
+    if (it != nodes_[node_index].children.end()) {
+      node_index = it->second;
+      continue;
+    }
+    const uint32_t child_index = static_cast<uint32_t>(nodes_.size());
+    nodes_[node_index].children.emplace(std::string(label), child_index);
+    nodes_.emplace_back();
+    node_index = child_index;
+  }
+  int32_t& ruleset_index =
+      is_wildcard ? nodes_[node_index].wildcard : nodes_[node_index].exact;
+  ruleset_index = static_cast<int32_t>(rulesets_.size());
+  rulesets_.push_back(std::move(ruleset));
+  return true;
+}
+
+std::string HTTPSEverywhereRuleset::GetHTTPSURL(const GURL& url) {
+  base::StringPiece host = url.host_piece();
+  if (!host.empty() && host.back() == '.') {
+    host.remove_suffix(1);
+  }
+  return ApplyRulesForHost(0, host, 0, url.spec());
+}
+
+std::string HTTPSEverywhereRuleset::ApplyRulesForHost(uint32_t node_index,
+                                                      base::StringPiece host,
+                                                      size_t depth,
+                                                      const std::string& spec) {
+  // Once all of the labels have been walked, only the ruleset for the host
+  // itself applies. As with the database, neither it nor the ruleset for the
+  // subdomains of a top level domain is looked up.
+  if (host.empty()) {
+    const int32_t exact = nodes_[node_index].exact;
+    return depth >= 2 && exact >= 0 ? ApplyRuleset(*rulesets_[exact], spec)
+                                     : std::string();
+  }
+
+  const size_t dot = host.rfind('.');
+  const base::StringPiece label =
+      dot == base::StringPiece::npos ? host : host.substr(dot + 1);
+  auto it = nodes_[node_index].children.find(label);
+  if (it != nodes_[node_index].children.end()) {
+    std::string new_url = ApplyRulesForHost(
+        it->second,
+        dot == base::StringPiece::npos ? base::StringPiece()
+                                       : host.substr(0, dot),
+        depth + 1, spec);
+    if (!new_url.empty()) {
+      return new_url;
+    }
+  }
+
+  const int32_t wildcard = nodes_[node_index].wildcard;
+  return depth >= 2 && wildcard >= 0 ? ApplyRuleset(*rulesets_[wildcard], spec)
+                                     : std::string();
+}
+
+std::string HTTPSEverywhereRuleset::ApplyRuleset(Ruleset& ruleset,
+                                                 const std::string& spec) {
+  if (!ruleset.compiled) {
+    ruleset.Compile();
+  }
+
+  for (const Ruleset::Group& group : ruleset.groups) {
+    if (group.exclusion_set && group.exclusion_set->Match(spec, nullptr)) {
+      return std::string();
+    }
+    if (!group.has_rules) {
+      return std::string();
+    }
+    for (const Ruleset::Rule& rule : group.rules) {
+      if (!rule.from_regex) {
+        std::string new_url(spec);
+        return new_url.insert(4, "s");
+      }
+      if (!rule.from_regex->ok()) {
+        continue;
+      }
+      // Replace() reports whether the rule matched, so the URL is only
+      // searched once.
+      std::string new_url(spec);
+      if (re2::RE2::Replace(&new_url, *rule.from_regex, rule.to) &&
+          new_url != spec) {
+        return new_url;
+      }
+    }
+  }
+  return std::string();
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,78 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULESET_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULESET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/strings/string_piece.h"
+
+class GURL;
+
+namespace brave_shields {
+
+// The rules of the HTTPS Everywhere database, parsed once and indexed by a
+// trie of host labels so that URLs can be upgraded without reading or parsing
+// anything per request. The regexes of a ruleset are compiled the first time
+// a URL is looked up against it, and kept.
+//
+// Not thread safe: lookups compile regexes, so all calls have to be made on
+// the same sequence.
+class HTTPSEverywhereRuleset {
+ public:
+  HTTPSEverywhereRuleset();
+  HTTPSEverywhereRuleset(const HTTPSEverywhereRuleset&) = delete;
+  HTTPSEverywhereRuleset& operator=(const HTTPSEverywhereRuleset&) = delete;
+  ~HTTPSEverywhereRuleset();
+
+  // Adds the rules stored under `key` in the database. Keys are hosts with
+  // their labels reversed, such as "com.example.www", or "com.example.*" for
+  // the subdomains of example.com. Returns false if the rules can't be parsed.
+  bool AddRules(base::StringPiece key, base::StringPiece rules_json);
+
+  // Returns the HTTPS URL for `url`, trying the rules for its host before the
+  // ones for its parent domains, or an empty string if no rule upgrades it.
+  std::string GetHTTPSURL(const GURL& url);
+
+  size_t ruleset_count() const { return rulesets_.size(); }
+
+ private:
+  struct Ruleset;
+
+  struct Node {
+    Node();
+    Node(Node&&);
+    Node& operator=(Node&&);
+    ~Node();
+
+    base::flat_map<std::string, uint32_t> children;
+    // Index of the ruleset for the host of this node, if any.
+    int32_t exact = -1;
+    // Index of the ruleset for the subdomains of this node, if any.
+    int32_t wildcard = -1;
+  };
+
+  // Walks down from `node_index` along the labels at the end of `host`, and
+  // applies the rulesets found on the way back up.
+  std::string ApplyRulesForHost(uint32_t node_index,
+                                base::StringPiece host,
+                                size_t depth,
+                                const std::string& spec);
+  std::string ApplyRuleset(Ruleset& ruleset, const std::string& spec);
+
+  std::vector<Node> nodes_;
+  std::vector<std::unique_ptr<Ruleset>> rulesets_;
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULESET_H_
@@ -0,0 +1,155 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_ruleset.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/test/task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/time/time.h"
+#include "brave/components/brave_shields/browser/https_everywhere_service.h"
+#include "brave/components/brave_shields/common/features.h"
+#include "brave/components/constants/brave_paths.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr char kDiggRules[] =
+    R"([{"r":[{"f":"^http://((?:static|widgets|www)\\.)?digg\\.com/",)"
+    R"("t":"https://$1digg.com/"}]}])";
+
+}  // namespace
+
+TEST(HTTPSEverywhereRulesetTest, UpgradesHostAndSubdomains) {
+  HTTPSEverywhereRuleset ruleset;
+  ASSERT_TRUE(ruleset.AddRules("com.digg", kDiggRules));
+  ASSERT_TRUE(ruleset.AddRules("com.digg.*", kDiggRules));
+
+  EXPECT_EQ("https://digg.com/", ruleset.GetHTTPSURL(GURL("http://digg.com/")));
+  EXPECT_EQ("https://www.digg.com/news",
+            ruleset.GetHTTPSURL(GURL("http://www.digg.com/news")));
+  EXPECT_EQ("https://widgets.digg.com/",
+            ruleset.GetHTTPSURL(GURL("http://widgets.digg.com/")));
+  // The rule itself doesn't match this subdomain.
+  EXPECT_EQ("", ruleset.GetHTTPSURL(GURL("http://other.digg.com/")));
+  EXPECT_EQ("", ruleset.GetHTTPSURL(GURL("http://digg.org/")));
+  EXPECT_EQ("", ruleset.GetHTTPSURL(GURL("http://notdigg.com/")));
+}
+
+TEST(HTTPSEverywhereRulesetTest, TriesHostBeforeParentDomains) {
+  HTTPSEverywhereRuleset ruleset;
+  ASSERT_TRUE(ruleset.AddRules("com.example.*", R"([{"r":[{"d":1}]}])"));
+  ASSERT_TRUE(ruleset.AddRules("com.example.www",
+                               R"([{"r":[{"f":"^http://www\\.example\\.com/",)"
+                               R"("t":"https://example.com/"}]}])"));
+
+  EXPECT_EQ("https://example.com/a",
+            ruleset.GetHTTPSURL(GURL("http://www.example.com/a")));
+  EXPECT_EQ("https://cdn.example.com/a",
+            ruleset.GetHTTPSURL(GURL("http://cdn.example.com/a")));
+  // Wildcards only apply to subdomains.
+  EXPECT_EQ("", ruleset.GetHTTPSURL(GURL("http://example.com/a")));
+}
+
+TEST(HTTPSEverywhereRulesetTest, ExclusionsStopTheLookup) {
+  HTTPSEverywhereRuleset ruleset;
+  ASSERT_TRUE(ruleset.AddRules(
+      "jp.kumapon",
+      R"([{"r":[{"d":1}],"e":[{"p":"^http://kumapon\\.jp/$"}]}])"));
+
+  EXPECT_EQ("", ruleset.GetHTTPSURL(GURL("http://kumapon.jp/")));
+  EXPECT_EQ("https://kumapon.jp/deals",
+            ruleset.GetHTTPSURL(GURL("http://kumapon.jp/deals")));
+}
+
+TEST(HTTPSEverywhereRulesetTest, RejectsMalformedRules) {
+  HTTPSEverywhereRuleset ruleset;
+  EXPECT_FALSE(ruleset.AddRules("com.example", "{"));
+  EXPECT_FALSE(ruleset.AddRules("com.example", R"({"r":[]})"));
+  EXPECT_FALSE(ruleset.AddRules("", R"([{"r":[{"d":1}]}])"));
+  EXPECT_EQ(0u, ruleset.ruleset_count());
+
+  // Invalid regexes never match.
+  ASSERT_TRUE(ruleset.AddRules(
+      "com.example", R"([{"r":[{"f":"^http://(","t":"https://"}]}])"));
+  EXPECT_EQ("", ruleset.GetHTTPSURL(GURL("http://example.com/")));
+}
+
+// Compares the precompiled ruleset with reading and parsing the rules from the
+// database for each lookup, over the rules in the test data.
+TEST(HTTPSEverywhereRulesetTest, BenchmarkAgainstDatabase) {
+  base::test::TaskEnvironment task_environment;
+  constexpr size_t kLookupCount = 2000;
+
+  base::FilePath test_data_dir;
+  ASSERT_TRUE(base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir));
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
+  std::unique_ptr<HTTPSEverywhereService> services[2];
+  for (size_t i = 0; i < 2; i++) {
+    base::test::ScopedFeatureList feature_list;
+    feature_list.InitWithFeatureState(features::kBraveHTTPSEverywhereRuleset,
+                                      i == 1);
+    const base::FilePath install_dir =
+        temp_dir.GetPath().AppendASCII(base::NumberToString(i));
+    ASSERT_TRUE(base::CopyDirectory(
+        test_data_dir.AppendASCII("https-everywhere-data"), install_dir,
+        true));
+    services[i] = HTTPSEverywhereServiceFactory(
+        base::SequencedTaskRunnerHandle::Get());
+    services[i]->InitDB(install_dir);
+    task_environment.RunUntilIdle();
+  }
+
+  // One lookup in four is on a host with rules. Every URL is different so that
+  // the recently used cache doesn't serve any of them.
+  constexpr const char* kHostsWithRules[] = {
+      "www.digg.com", "btdigg.org", "raw.githubusercontent.com",
+      "www.mozilla-russia.org"};
+  std::vector<GURL> urls;
+  for (size_t i = 0; i < kLookupCount; i++) {
+    urls.emplace_back(
+        i % 4 == 0
+            ? base::StringPrintf("http://%s/%zu", kHostsWithRules[i / 4 % 4], i)
+            : base::StringPrintf("http://www.site%zu.example/%zu", i % 100,
+                                 i));
+  }
+
+  perf_test::PerfResultReporter reporter(
+      "HTTPSEverywhere", base::NumberToString(kLookupCount) + "_lookups");
+  std::string results[2];
+  for (size_t i = 0; i < 2; i++) {
+    const std::string metric = i == 0 ? ".database" : ".ruleset";
+    reporter.RegisterImportantMetric(metric, "ms");
+    base::WeakPtr<HTTPSEverywhereService::Engine> engine =
+        services[i]->engine();
+    const base::TimeTicks start = base::TimeTicks::Now();
+    for (size_t j = 0; j < urls.size(); j++) {
+      std::string new_url;
+      engine->GetHTTPSURL(&urls[j], j + 1, &new_url);
+      results[i] += new_url + "\n";
+    }
+    reporter.AddResult(metric, base::TimeTicks::Now() - start);
+  }
+
+  EXPECT_EQ(results[0], results[1]);
+  EXPECT_NE(std::string::npos, results[1].find("https://www.digg.com/0\n"));
+}
+
+}  // namespace brave_shields
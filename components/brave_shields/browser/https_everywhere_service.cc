@@ -12,6 +12,7 @@
 
 #include "base/base_paths.h"
 #include "base/bind.h"
+#include "base/feature_list.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
@@ -20,7 +21,9 @@
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/scoped_blocking_call.h"
 #include "base/values.h"
+#include "brave/components/brave_shields/common/features.h"
 #include "third_party/leveldatabase/src/include/leveldb/db.h"
+#include "third_party/leveldatabase/src/include/leveldb/iterator.h"
 #include "third_party/re2/src/re2/re2.h"
 #include "third_party/zlib/google/zip.h"
 
@@ -120,6 +123,35 @@ void HTTPSEverywhereService::Engine::Init(const base::FilePath& base_dir) {
     CloseDatabase();
     return;
   }
+
+  if (base::FeatureList::IsEnabled(features::kBraveHTTPSEverywhereRuleset)) {
+    LoadRuleset();
+  }
+}
+
+void HTTPSEverywhereService::Engine::LoadRuleset() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto ruleset = std::make_unique<HTTPSEverywhereRuleset>();
+  std::unique_ptr<leveldb::Iterator> it(
+      level_db_->NewIterator(leveldb::ReadOptions()));
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    ruleset->AddRules(
+        base::StringPiece(it->key().data(), it->key().size()),
+        base::StringPiece(it->value().data(), it->value().size()));
+  }
+  if (!it->status().ok()) {
+    LOG(ERROR) << "Failed to read the HTTPSE rules: "
+               << it->status().ToString();
+    ruleset_.reset();
+    return;
+  }
+  it.reset();
+
+  ruleset_ = std::move(ruleset);
+  // The upgrades cached for the previous rules may no longer apply.
+  service_->recently_used_cache().clear();
+  // All lookups are served from the ruleset from now on.
+  CloseDatabase();
 }
 
 bool HTTPSEverywhereService::Engine::GetHTTPSURL(
@@ -131,7 +163,7 @@ bool HTTPSEverywhereService::Engine::GetHTTPSURL(
   if (!url->is_valid())
     return false;
 
-  if (!level_db_ || url->scheme() == url::kHttpsScheme) {
+  if ((!level_db_ && !ruleset_) || url->scheme() == url::kHttpsScheme) {
     return false;
   }
 
@@ -139,7 +171,8 @@ bool HTTPSEverywhereService::Engine::GetHTTPSURL(
     return false;
   }
 
-  if (service_->recently_used_cache().get(url->spec(), new_url)) {
+  // The ruleset is as quick to look up as the cache, and doesn't need a lock.
+  if (!ruleset_ && service_->recently_used_cache().get(url->spec(), new_url)) {
     service_->AddHTTPSEUrlToRedirectList(request_identifier);
     return true;
   }
@@ -152,6 +185,17 @@ bool HTTPSEverywhereService::Engine::GetHTTPSURL(
   }
 
   SCOPED_UMA_HISTOGRAM_TIMER("Brave.HTTPSE.GetHTTPSURL");
+  if (ruleset_) {
+    *new_url = ruleset_->GetHTTPSURL(candidate_url);
+    if (new_url->empty()) {
+      return false;
+    }
+    // Lets the UI thread upgrade the URL without posting here the next time.
+    service_->recently_used_cache().add(candidate_url.spec(), *new_url);
+    service_->AddHTTPSEUrlToRedirectList(request_identifier);
+    return true;
+  }
+
   const std::vector<std::string> domains =
       ExpandDomainForLookup(candidate_url.host());
   for (auto domain : domains) {
@@ -16,6 +16,7 @@
 #include "base/synchronization/lock.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "brave/components/brave_shields/browser/https_everywhere_recently_used_cache.h"
+#include "brave/components/brave_shields/browser/https_everywhere_ruleset.h"
 
 namespace leveldb {
 class DB;
@@ -66,9 +67,13 @@ class HTTPSEverywhereService : public BaseBraveShieldsService {
     std::string ApplyHTTPSRule(const std::string& originalUrl,
                                const std::string& rule);
     std::string CorrecttoRuleToRE2Engine(const std::string& to);
+    // Reads all of the rules in the database into `ruleset_`.
+    void LoadRuleset();
     void CloseDatabase();
 
     leveldb::DB* level_db_;
+    // Used instead of the database when the precompiled ruleset is enabled.
+    std::unique_ptr<HTTPSEverywhereRuleset> ruleset_;
     HTTPSEverywhereService* service_;  // not owned
     SEQUENCE_CHECKER(sequence_checker_);
   };
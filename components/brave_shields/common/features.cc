@@ -23,6 +23,12 @@ BASE_FEATURE(kBraveAdblockDefault1pBlocking,
 BASE_FEATURE(kBraveAdblockCnameUncloaking,
              "BraveAdblockCnameUncloaking",
              base::FEATURE_ENABLED_BY_DEFAULT);
+// When enabled, the canonical names found by CNAME uncloaking are cached per
+// network context, and hosts which the adblock engines allow are resolved while
+// their requests are matched against the engines rather than afterwards.
+BASE_FEATURE(kBraveAdblockCnameCache,
+             "BraveAdblockCnameCache",
+             base::FEATURE_DISABLED_BY_DEFAULT);
 // When enabled, Brave will apply HTML element collapsing to all images and
 // iframes that initiate a blocked network request.
 BASE_FEATURE(kBraveAdblockCollapseBlockedElements,
@@ -47,6 +53,28 @@ BASE_FEATURE(kBraveAdblockCosmeticFilteringChildFrames,
 BASE_FEATURE(kBraveAdblockCspRules,
              "BraveAdblockCspRules",
              base::FEATURE_ENABLED_BY_DEFAULT);
+// When enabled, the combined results of matching requests and CSP directives
+// against the adblock engines are cached until any engine changes.
+BASE_FEATURE(kBraveAdblockDecisionCache,
+             "BraveAdblockDecisionCache",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+// When enabled, the regional lists, list subscriptions and custom filters are
+// compiled into a single engine so that each request is matched against them
+// once instead of once per list.
+BASE_FEATURE(kBraveAdblockMergedEngine,
+             "BraveAdblockMergedEngine",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+// When enabled, network requests are matched on the thread pool against
+// snapshots of the adblock engines instead of being queued on the adblock task
+// runner, so that requests don't wait for each other or for lists to reload.
+BASE_FEATURE(kBraveAdblockParallelMatching,
+             "BraveAdblockParallelMatching",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+// When enabled, the selectors which the adblock engines hide for the classes
+// and ids seen on pages are cached per origin until any engine changes.
+BASE_FEATURE(kBraveAdblockSelectorCache,
+             "BraveAdblockSelectorCache",
+             base::FEATURE_DISABLED_BY_DEFAULT);
 // When enabled, Brave will block domains listed in the user's selected adblock
 // filters and present a security interstitial with choice to proceed and
 // optionally whitelist the domain.
@@ -67,6 +95,12 @@ BASE_FEATURE(kBraveDomainBlock1PES,
 BASE_FEATURE(kBraveExtensionNetworkBlocking,
              "BraveExtensionNetworkBlocking",
              base::FEATURE_DISABLED_BY_DEFAULT);
+// When enabled, the HTTPS Everywhere database is read into memory and its rules
+// parsed once when the component is installed, instead of being read and
+// parsed for each request.
+BASE_FEATURE(kBraveHTTPSEverywhereRuleset,
+             "BraveHTTPSEverywhereRuleset",
+             base::FEATURE_DISABLED_BY_DEFAULT);
 // When enabled, language headers and APIs may be altered by Brave Shields.
 BASE_FEATURE(kBraveReduceLanguage,
              "BraveReduceLanguage",
@@ -75,10 +109,11 @@ BASE_FEATURE(kBraveReduceLanguage,
 BASE_FEATURE(kBraveDarkModeBlock,
              "BraveDarkModeBlock",
              base::FEATURE_ENABLED_BY_DEFAULT);
-// load the cosmetic filter rules using sync ipc
+// load the cosmetic filter rules using sync ipc, instead of having the browser
+// push them to the frame when its navigation is ready to commit
 BASE_FEATURE(kCosmeticFilteringSyncLoad,
              "CosmeticFilterSyncLoad",
-             base::FEATURE_ENABLED_BY_DEFAULT);
+             base::FEATURE_DISABLED_BY_DEFAULT);
 
 // Enables extra TRACE_EVENTs in content filter js. The feature is
 // primary designed for local debugging.
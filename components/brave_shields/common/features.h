@@ -15,15 +15,21 @@ namespace brave_shields {
 namespace features {
 BASE_DECLARE_FEATURE(kBraveAdblockDefault1pBlocking);
 BASE_DECLARE_FEATURE(kBraveAdblockCnameUncloaking);
+BASE_DECLARE_FEATURE(kBraveAdblockCnameCache);
 BASE_DECLARE_FEATURE(kBraveAdblockCollapseBlockedElements);
 BASE_DECLARE_FEATURE(kBraveAdblockCookieListDefault);
 BASE_DECLARE_FEATURE(kBraveAdblockCookieListOptIn);
 BASE_DECLARE_FEATURE(kBraveAdblockCosmeticFiltering);
 BASE_DECLARE_FEATURE(kBraveAdblockCosmeticFilteringChildFrames);
 BASE_DECLARE_FEATURE(kBraveAdblockCspRules);
+BASE_DECLARE_FEATURE(kBraveAdblockDecisionCache);
+BASE_DECLARE_FEATURE(kBraveAdblockMergedEngine);
+BASE_DECLARE_FEATURE(kBraveAdblockParallelMatching);
+BASE_DECLARE_FEATURE(kBraveAdblockSelectorCache);
 BASE_DECLARE_FEATURE(kBraveDomainBlock);
 BASE_DECLARE_FEATURE(kBraveDomainBlock1PES);
 BASE_DECLARE_FEATURE(kBraveExtensionNetworkBlocking);
+BASE_DECLARE_FEATURE(kBraveHTTPSEverywhereRuleset);
 BASE_DECLARE_FEATURE(kBraveReduceLanguage);
 BASE_DECLARE_FEATURE(kBraveDarkModeBlock);
 BASE_DECLARE_FEATURE(kCosmeticFilteringSyncLoad);
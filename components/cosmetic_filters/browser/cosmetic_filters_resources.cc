@@ -7,15 +7,33 @@
 
 #include <utility>
 
-#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
 #include "base/values.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "components/content_settings/core/browser/host_content_settings_map.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
+#include "url/gurl.h"
+#include "url/origin.h"
 
 namespace cosmetic_filters {
 
+namespace {
+
+void AppendStringList(const base::Value::List* list,
+                      std::vector<std::string>* out) {
+  if (!list) {
+    return;
+  }
+  for (const auto& item : *list) {
+    if (item.is_string()) {
+      out->push_back(item.GetString());
+    }
+  }
+}
+
+}  // namespace
+
 CosmeticFiltersResources::CosmeticFiltersResources(
     brave_shields::AdBlockService* ad_block_service)
     : ad_block_service_(ad_block_service) {}
@@ -23,56 +41,79 @@ CosmeticFiltersResources::CosmeticFiltersResources(
 CosmeticFiltersResources::~CosmeticFiltersResources() = default;
 
 void CosmeticFiltersResources::HiddenClassIdSelectors(
-    const std::string& input,
+    const std::string& url,
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
     const std::vector<std::string>& exceptions,
     HiddenClassIdSelectorsCallback callback) {
   DCHECK(ad_block_service_->GetTaskRunner()->RunsTasksInCurrentSequence());
-  absl::optional<base::Value> input_value = base::JSONReader::Read(input);
-  if (!input_value) {
-    // Nothing to work with
-    std::move(callback).Run(base::Value::Dict());
-
-    return;
-  }
-  base::Value::Dict* input_dict = input_value->GetIfDict();
-  if (!input_dict) {
-    std::move(callback).Run(base::Value::Dict());
+  auto result = mojom::HiddenSelectors::New();
+  if (classes.empty() && ids.empty()) {
+    std::move(callback).Run(std::move(result));
     return;
   }
-  std::vector<std::string> classes;
-  base::Value::List* classes_list = input_dict->FindList("classes");
-  if (classes_list) {
-    for (const auto& class_item : *classes_list) {
-      if (!class_item.is_string()) {
-        continue;
-      }
-      classes.push_back(class_item.GetString());
-    }
-  }
-  std::vector<std::string> ids;
-  base::Value::List* ids_list = input_dict->FindList("ids");
-  if (ids_list) {
-    for (const auto& id_item : *ids_list) {
-      if (!id_item.is_string()) {
-        continue;
-      }
-      ids.push_back(id_item.GetString());
-    }
-  }
 
-  auto selectors =
-      ad_block_service_->HiddenClassIdSelectors(classes, ids, exceptions);
-
-  std::move(callback).Run(std::move(selectors));
+  brave_shields::HiddenSelectors selectors =
+      ad_block_service_->HiddenClassIdSelectors(
+          url::Origin::Create(GURL(url)), classes, ids, exceptions);
+  result->hide_selectors = std::move(selectors.hide_selectors);
+  result->force_hide_selectors = std::move(selectors.force_hide_selectors);
+  std::move(callback).Run(std::move(result));
 }
 
 void CosmeticFiltersResources::UrlCosmeticResources(
     const std::string& url,
     UrlCosmeticResourcesCallback callback) {
   DCHECK(ad_block_service_->GetTaskRunner()->RunsTasksInCurrentSequence());
-  auto resources = ad_block_service_->UrlCosmeticResources(url);
-  std::move(callback).Run(resources ? std::move(resources.value())
-                                    : base::Value());
+  std::move(callback).Run(GetUrlCosmeticResources(ad_block_service_, url));
+}
+
+// static
+mojom::UrlCosmeticResourcesPtr
+CosmeticFiltersResources::GetUrlCosmeticResources(
+    brave_shields::AdBlockService* ad_block_service,
+    const std::string& url) {
+  DCHECK(ad_block_service->GetTaskRunner()->RunsTasksInCurrentSequence());
+  absl::optional<base::Value> resources =
+      ad_block_service->UrlCosmeticResources(url);
+  base::Value::Dict* resources_dict =
+      resources ? resources->GetIfDict() : nullptr;
+  if (!resources_dict) {
+    return nullptr;
+  }
+
+  auto result = mojom::UrlCosmeticResources::New();
+  if (const base::Value* injected_script =
+          resources_dict->Find("injected_script")) {
+    base::JSONWriter::Write(*injected_script, &result->injected_script);
+  }
+  AppendStringList(resources_dict->FindList("hide_selectors"),
+                   &result->hide_selectors);
+  AppendStringList(resources_dict->FindList("exceptions"),
+                   &result->exceptions);
+  result->generichide = resources_dict->FindBool("generichide").value_or(false);
+
+  if (const base::Value::List* force_hide_selectors =
+          resources_dict->FindList("force_hide_selectors")) {
+    for (const auto& selector : *force_hide_selectors) {
+      DCHECK(selector.is_string());
+      result->stylesheet += selector.GetString() + "{display:none !important}";
+    }
+  }
+  if (const base::Value::Dict* style_selectors =
+          resources_dict->FindDict("style_selectors")) {
+    for (const auto kv : *style_selectors) {
+      DCHECK(kv.second.is_list());
+      result->stylesheet += kv.first + '{';
+      for (const auto& style : kv.second.GetList()) {
+        DCHECK(style.is_string());
+        result->stylesheet += style.GetString() + ';';
+      }
+      result->stylesheet += '}';
+    }
+  }
+
+  return result;
 }
 
 }  // namespace cosmetic_filters
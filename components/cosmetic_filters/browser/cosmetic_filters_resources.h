@@ -36,9 +36,18 @@ class CosmeticFiltersResources final
       brave_shields::AdBlockService* ad_block_service);
   ~CosmeticFiltersResources() override;
 
+  // Looks up the initial set of rules and scripts to apply for the given URL,
+  // and serializes them for the renderer. Must be called on the task runner of
+  // `ad_block_service`.
+  static mojom::UrlCosmeticResourcesPtr GetUrlCosmeticResources(
+      brave_shields::AdBlockService* ad_block_service,
+      const std::string& url);
+
   // Sends back to renderer a response about rules that has to be applied
-  // for the specified selectors.
-  void HiddenClassIdSelectors(const std::string& input,
+  // for the specified classes and ids.
+  void HiddenClassIdSelectors(const std::string& url,
+                              const std::vector<std::string>& classes,
+                              const std::vector<std::string>& ids,
                               const std::vector<std::string>& exceptions,
                               HiddenClassIdSelectorsCallback callback) override;
 
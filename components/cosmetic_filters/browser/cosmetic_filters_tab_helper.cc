@@ -0,0 +1,103 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/cosmetic_filters/browser/cosmetic_filters_tab_helper.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/feature_list.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/trace_event/trace_event.h"
+#include "brave/components/brave_shields/browser/ad_block_service.h"
+#include "brave/components/brave_shields/common/features.h"
+#include "brave/components/cosmetic_filters/browser/cosmetic_filters_resources.h"
+#include "content/public/browser/navigation_handle.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/web_contents.h"
+#include "third_party/blink/public/common/associated_interfaces/associated_interface_provider.h"
+#include "url/gurl.h"
+
+namespace cosmetic_filters {
+
+CosmeticFiltersTabHelper::CosmeticFiltersTabHelper(
+    content::WebContents* web_contents,
+    brave_shields::AdBlockService* ad_block_service)
+    : content::WebContentsObserver(web_contents),
+      content::WebContentsUserData<CosmeticFiltersTabHelper>(*web_contents),
+      ad_block_service_(ad_block_service) {}
+
+CosmeticFiltersTabHelper::~CosmeticFiltersTabHelper() = default;
+
+// static
+void CosmeticFiltersTabHelper::MaybeCreateForWebContents(
+    content::WebContents* web_contents,
+    brave_shields::AdBlockService* ad_block_service) {
+  if (!ad_block_service ||
+      base::FeatureList::IsEnabled(
+          brave_shields::features::kCosmeticFilteringSyncLoad)) {
+    return;
+  }
+
+  CreateForWebContents(web_contents, ad_block_service);
+}
+
+void CosmeticFiltersTabHelper::ReadyToCommitNavigation(
+    content::NavigationHandle* navigation_handle) {
+  const GURL& url = navigation_handle->GetURL();
+  if (navigation_handle->IsSameDocument() || !url.SchemeIsHTTPOrHTTPS()) {
+    return;
+  }
+
+  content::RenderFrameHost* rfh = navigation_handle->GetRenderFrameHost();
+  // This isn't ordered with the navigation commit. The frame only waits for
+  // the resources if this arrives before the navigation is ready to commit in
+  // the renderer, and otherwise asks for them itself. |token| lets it drop the
+  // results of any other lookup.
+  const base::UnguessableToken token = base::UnguessableToken::Create();
+  GetAgent(rfh)->WillSendUrlCosmeticResources(url.spec(), token);
+
+  TRACE_EVENT1("brave.adblock", "CosmeticFiltersTabHelper::LookUp", "url",
+               url.spec());
+  ad_block_service_->GetTaskRunner()->PostTaskAndReplyWithResult(
+      FROM_HERE,
+      base::BindOnce(&CosmeticFiltersResources::GetUrlCosmeticResources,
+                     base::Unretained(ad_block_service_.get()), url.spec()),
+      base::BindOnce(&CosmeticFiltersTabHelper::OnUrlCosmeticResources,
+                     weak_factory_.GetWeakPtr(), rfh->GetGlobalId(), token));
+}
+
+void CosmeticFiltersTabHelper::RenderFrameDeleted(
+    content::RenderFrameHost* rfh) {
+  agents_.erase(rfh);
+}
+
+void CosmeticFiltersTabHelper::OnUrlCosmeticResources(
+    content::GlobalRenderFrameHostId frame_id,
+    const base::UnguessableToken& token,
+    mojom::UrlCosmeticResourcesPtr resources) {
+  content::RenderFrameHost* rfh = content::RenderFrameHost::FromID(frame_id);
+  // The frame ignores resources for any lookup but the last one it was told
+  // about, so there's no need to check whether it has navigated again in the
+  // meantime.
+  if (!rfh || !rfh->IsRenderFrameLive()) {
+    return;
+  }
+
+  GetAgent(rfh)->SetUrlCosmeticResources(token, std::move(resources));
+}
+
+mojo::AssociatedRemote<mojom::CosmeticFiltersAgent>&
+CosmeticFiltersTabHelper::GetAgent(content::RenderFrameHost* rfh) {
+  auto& agent = agents_[rfh];
+  if (!agent.is_bound()) {
+    rfh->GetRemoteAssociatedInterfaces()->GetInterface(&agent);
+  }
+  return agent;
+}
+
+WEB_CONTENTS_USER_DATA_KEY_IMPL(CosmeticFiltersTabHelper);
+
+}  // namespace cosmetic_filters
@@ -0,0 +1,85 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_COSMETIC_FILTERS_BROWSER_COSMETIC_FILTERS_TAB_HELPER_H_
+#define BRAVE_COMPONENTS_COSMETIC_FILTERS_BROWSER_COSMETIC_FILTERS_TAB_HELPER_H_
+
+#include "base/containers/flat_map.h"
+#include "base/memory/raw_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/unguessable_token.h"
+#include "brave/components/cosmetic_filters/common/cosmetic_filters.mojom.h"
+#include "content/public/browser/global_routing_id.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "content/public/browser/web_contents_user_data.h"
+#include "mojo/public/cpp/bindings/associated_remote.h"
+
+namespace brave_shields {
+class AdBlockService;
+}
+
+namespace content {
+class NavigationHandle;
+class RenderFrameHost;
+class WebContents;
+}  // namespace content
+
+namespace cosmetic_filters {
+
+// Starts looking up the cosmetic resources of each document on the adblock
+// task runner as soon as its navigation is ready to commit, and pushes them to
+// the frame through mojom::CosmeticFiltersAgent. This way they are usually
+// available by the time the document starts, without the renderer main thread
+// having to wait on an IPC for them.
+class CosmeticFiltersTabHelper
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<CosmeticFiltersTabHelper> {
+ public:
+  CosmeticFiltersTabHelper(const CosmeticFiltersTabHelper&) = delete;
+  CosmeticFiltersTabHelper& operator=(const CosmeticFiltersTabHelper&) =
+      delete;
+  ~CosmeticFiltersTabHelper() override;
+
+  // Does nothing if the resources are loaded by the renderer instead, see the
+  // CosmeticFilterSyncLoad feature.
+  static void MaybeCreateForWebContents(
+      content::WebContents* web_contents,
+      brave_shields::AdBlockService* ad_block_service);
+
+ private:
+  friend class content::WebContentsUserData<CosmeticFiltersTabHelper>;
+
+  CosmeticFiltersTabHelper(content::WebContents* web_contents,
+                           brave_shields::AdBlockService* ad_block_service);
+
+  // content::WebContentsObserver overrides.
+  void ReadyToCommitNavigation(
+      content::NavigationHandle* navigation_handle) override;
+  void RenderFrameDeleted(content::RenderFrameHost* rfh) override;
+
+  void OnUrlCosmeticResources(content::GlobalRenderFrameHostId frame_id,
+                              const base::UnguessableToken& token,
+                              mojom::UrlCosmeticResourcesPtr resources);
+
+  mojo::AssociatedRemote<mojom::CosmeticFiltersAgent>& GetAgent(
+      content::RenderFrameHost* rfh);
+
+  const raw_ptr<brave_shields::AdBlockService> ad_block_service_ =
+      nullptr;  // Not owned
+
+  // Remotes are kept for as long as their frame lives, so that the resources
+  // are delivered after WillSendUrlCosmeticResources().
+  base::flat_map<content::RenderFrameHost*,
+                 mojo::AssociatedRemote<mojom::CosmeticFiltersAgent>>
+      agents_;
+
+  base::WeakPtrFactory<CosmeticFiltersTabHelper> weak_factory_{this};
+
+  WEB_CONTENTS_USER_DATA_KEY_DECL();
+};
+
+}  // namespace cosmetic_filters
+
+#endif  // BRAVE_COMPONENTS_COSMETIC_FILTERS_BROWSER_COSMETIC_FILTERS_TAB_HELPER_H_
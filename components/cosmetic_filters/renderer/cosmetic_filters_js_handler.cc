@@ -9,7 +9,7 @@
 
 #include "base/bind.h"
 #include "base/feature_list.h"
-#include "base/json/json_writer.h"
+#include "base/json/string_escape.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/no_destructor.h"
 #include "base/strings/stringprintf.h"
@@ -142,6 +142,19 @@ bool IsVettedSearchEngine(const GURL& url) {
   return false;
 }
 
+// Serializes the selectors as a JSON array, to inline them into a script.
+std::string SerializeSelectors(const std::vector<std::string>& selectors) {
+  std::string json = "[";
+  for (size_t i = 0; i < selectors.size(); i++) {
+    if (i > 0) {
+      json += ',';
+    }
+    base::EscapeJSONString(selectors[i], /*put_in_quotes*/ true, &json);
+  }
+  json += ']';
+  return json;
+}
+
 // ID is used in TRACE_ID_WITH_SCOPE(). Must be unique accoss the process.
 int MakeUniquePerfId() {
   static int counter = 0;
@@ -204,15 +217,21 @@ CosmeticFiltersJSHandler::CosmeticFiltersJSHandler(
   }
 }
 
-CosmeticFiltersJSHandler::~CosmeticFiltersJSHandler() = default;
+CosmeticFiltersJSHandler::~CosmeticFiltersJSHandler() {
+  RecordPageMetrics();
+}
 
 void CosmeticFiltersJSHandler::HiddenClassIdSelectors(
-    const std::string& input) {
-  if (!EnsureConnected())
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids) {
+  if ((classes.empty() && ids.empty()) || !EnsureConnected())
     return;
 
+  hidden_class_id_requests_++;
+  UMA_HISTOGRAM_COUNTS_1000("Brave.CosmeticFilters.HiddenClassIdSelectorsNames",
+                            classes.size() + ids.size());
   cosmetic_filters_resources_->HiddenClassIdSelectors(
-      input, exceptions_,
+      url_.spec(), classes, ids, exceptions_,
       base::BindOnce(&CosmeticFiltersJSHandler::OnHiddenClassIdSelectors,
                      base::Unretained(this)));
 }
@@ -336,10 +355,9 @@ void CosmeticFiltersJSHandler::OnRemoteDisconnect() {
   EnsureConnected();
 }
 
-bool CosmeticFiltersJSHandler::ProcessURL(
-    const GURL& url,
-    absl::optional<base::OnceClosure> callback) {
-  resources_dict_ = absl::nullopt;
+bool CosmeticFiltersJSHandler::ProcessURL(const GURL& url) {
+  RecordPageMetrics();
+  resources_.reset();
   url_ = url;
   enabled_1st_party_cf_ = false;
 
@@ -362,60 +380,56 @@ bool CosmeticFiltersJSHandler::ProcessURL(
       render_frame_->GetWebFrame()->IsCrossOriginToOutermostMainFrame() ||
       content_settings->IsFirstPartyCosmeticFilteringEnabled(url_);
 
-  if (callback.has_value()) {
-    SCOPED_UMA_HISTOGRAM_TIMER_MICROS(
-        "Brave.CosmeticFilters.UrlCosmeticResources");
-    TRACE_EVENT1("brave.adblock", "UrlCosmeticResources", "url", url_.spec());
-    cosmetic_filters_resources_->UrlCosmeticResources(
-        url_.spec(),
-        base::BindOnce(&CosmeticFiltersJSHandler::OnUrlCosmeticResources,
-                       base::Unretained(this), std::move(callback.value())));
-  } else {
-    TRACE_EVENT1("brave.adblock", "UrlCosmeticResourcesSync", "url",
-                 url_.spec());
-    SCOPED_UMA_HISTOGRAM_TIMER_MICROS(
-        "Brave.CosmeticFilters.UrlCosmeticResourcesSync");
-    base::Value result;
-    cosmetic_filters_resources_->UrlCosmeticResources(url_.spec(), &result);
+  return true;
+}
 
-    auto* dict = result.GetIfDict();
-    if (dict)
-      resources_dict_ = std::move(*dict);
-  }
+void CosmeticFiltersJSHandler::LoadUrlCosmeticResources(
+    base::OnceClosure callback) {
+  SCOPED_UMA_HISTOGRAM_TIMER_MICROS(
+      "Brave.CosmeticFilters.UrlCosmeticResources");
+  TRACE_EVENT1("brave.adblock", "UrlCosmeticResources", "url", url_.spec());
+  cosmetic_filters_resources_->UrlCosmeticResources(
+      url_.spec(),
+      base::BindOnce(&CosmeticFiltersJSHandler::OnUrlCosmeticResources,
+                     base::Unretained(this), std::move(callback)));
+}
 
-  return true;
+void CosmeticFiltersJSHandler::LoadUrlCosmeticResourcesSync() {
+  TRACE_EVENT1("brave.adblock", "UrlCosmeticResourcesSync", "url",
+               url_.spec());
+  SCOPED_UMA_HISTOGRAM_TIMER_MICROS(
+      "Brave.CosmeticFilters.UrlCosmeticResourcesSync");
+  cosmetic_filters_resources_->UrlCosmeticResources(url_.spec(), &resources_);
+}
+
+void CosmeticFiltersJSHandler::SetUrlCosmeticResources(
+    mojom::UrlCosmeticResourcesPtr resources) {
+  resources_ = std::move(resources);
 }
 
 void CosmeticFiltersJSHandler::OnUrlCosmeticResources(
     base::OnceClosure callback,
-    base::Value result) {
+    mojom::UrlCosmeticResourcesPtr resources) {
   if (!EnsureConnected())
     return;
 
-  auto* dict = result.GetIfDict();
-  if (dict)
-    resources_dict_ = std::move(*dict);
+  resources_ = std::move(resources);
 
   std::move(callback).Run();
 }
 
 void CosmeticFiltersJSHandler::ApplyRules(bool de_amp_enabled) {
   blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
-  if (!resources_dict_ || web_frame->IsProvisional())
+  if (!resources_ || web_frame->IsProvisional())
     return;
 
   SCOPED_UMA_HISTOGRAM_TIMER_MICROS("Brave.CosmeticFilters.ApplyRules");
   TRACE_EVENT1("brave.adblock", "ApplyRules", "url", url_.spec());
 
-  std::string scriptlet_script;
-  base::Value* injected_script = resources_dict_->Find("injected_script");
-  if (injected_script &&
-      base::JSONWriter::Write(*injected_script, &scriptlet_script)) {
-    scriptlet_script = base::StringPrintf(kScriptletInitScript,
-                                          de_amp_enabled ? "true" : "false",
-                                          scriptlet_script.c_str());
-  }
-  if (!scriptlet_script.empty()) {
+  if (!resources_->injected_script.empty()) {
+    const std::string scriptlet_script = base::StringPrintf(
+        kScriptletInitScript, de_amp_enabled ? "true" : "false",
+        resources_->injected_script.c_str());
     web_frame->ExecuteScriptInIsolatedWorld(
         isolated_world_id_,
         blink::WebScriptSource(blink::WebString::FromUTF8(scriptlet_script)),
@@ -429,7 +443,7 @@ void CosmeticFiltersJSHandler::ApplyRules(bool de_amp_enabled) {
   }
 
   // Working on css rules
-  generichide_ = resources_dict_->FindBool("generichide").value_or(false);
+  generichide_ = resources_->generichide;
   namespace bf = brave_shields::features;
   std::string cosmetic_filtering_init_script = base::StringPrintf(
       kCosmeticFilteringInitScript, enabled_1st_party_cf_ ? "true" : "false",
@@ -449,48 +463,36 @@ void CosmeticFiltersJSHandler::ApplyRules(bool de_amp_enabled) {
       blink::BackForwardCacheAware::kAllow);
   ExecuteObservingBundleEntryPoint();
 
-  CSSRulesRoutine(*resources_dict_);
+  CSSRulesRoutine(*resources_);
 }
 
 void CosmeticFiltersJSHandler::CSSRulesRoutine(
-    const base::Value::Dict& resources_dict) {
+    const mojom::UrlCosmeticResources& resources) {
   SCOPED_UMA_HISTOGRAM_TIMER_MICROS("Brave.CosmeticFilters.CSSRulesRoutine");
   TRACE_EVENT1("brave.adblock", "CSSRulesRoutine", "url", url_.spec());
 
   blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
-  const auto* cf_exceptions_list = resources_dict.FindList("exceptions");
-  if (cf_exceptions_list) {
-    for (const auto& item : *cf_exceptions_list) {
-      DCHECK(item.is_string());
-      exceptions_.push_back(item.GetString());
-    }
-  }
+  exceptions_.insert(exceptions_.end(), resources.exceptions.begin(),
+                     resources.exceptions.end());
   // If its a vetted engine AND we're not in aggressive mode, don't apply
   // cosmetic filtering from the default engine.
-  const auto* hide_selectors_list =
-      (IsVettedSearchEngine(url_) && !enabled_1st_party_cf_)
-          ? nullptr
-          : resources_dict.FindList("hide_selectors");
+  const bool apply_hide_selectors =
+      !IsVettedSearchEngine(url_) || enabled_1st_party_cf_;
 
   std::string stylesheet = "";
 
-  if (hide_selectors_list && !hide_selectors_list->empty()) {
+  if (apply_hide_selectors && !resources.hide_selectors.empty()) {
     // treat `hide_selectors` the same as `force_hide_selectors` if aggressive
     // mode is enabled.
     if (enabled_1st_party_cf_) {
-      for (auto& selector : *hide_selectors_list) {
-        DCHECK(selector.is_string());
-        stylesheet += selector.GetString() + "{display:none !important}";
+      for (const auto& selector : resources.hide_selectors) {
+        stylesheet += selector + "{display:none !important}";
       }
     } else {
-      std::string json_selectors;
-      base::JSONWriter::Write(*hide_selectors_list, &json_selectors);
-      if (json_selectors.empty()) {
-        json_selectors = "[]";
-      }
       // Building a script for stylesheet modifications
       std::string new_selectors_script = base::StringPrintf(
-          kHideSelectorsInjectScript, json_selectors.c_str());
+          kHideSelectorsInjectScript,
+          SerializeSelectors(resources.hide_selectors).c_str());
       web_frame->ExecuteScriptInIsolatedWorld(
           isolated_world_id_,
           blink::WebScriptSource(
@@ -499,30 +501,8 @@ void CosmeticFiltersJSHandler::CSSRulesRoutine(
     }
   }
 
-  const auto* force_hide_selectors_list =
-      resources_dict.FindList("force_hide_selectors");
-  if (force_hide_selectors_list) {
-    for (auto& selector : *force_hide_selectors_list) {
-      DCHECK(selector.is_string());
-      stylesheet += selector.GetString() + "{display:none !important}";
-    }
-  }
-
-  const auto* style_selectors_dictionary =
-      resources_dict.FindDict("style_selectors");
-  if (style_selectors_dictionary) {
-    for (const auto kv : *style_selectors_dictionary) {
-      DCHECK(kv.second.is_list());
-      std::string selector = kv.first;
-      const auto& styles = kv.second.GetList();
-      stylesheet += selector + '{';
-      for (auto& style : styles) {
-        DCHECK(style.is_string());
-        stylesheet += style.GetString() + ';';
-      }
-      stylesheet += '}';
-    }
-  }
+  // The force hidden and style selectors come serialized from the browser.
+  stylesheet += resources.stylesheet;
 
   if (!stylesheet.empty()) {
     InjectStylesheet(stylesheet);
@@ -533,7 +513,7 @@ void CosmeticFiltersJSHandler::CSSRulesRoutine(
 }
 
 void CosmeticFiltersJSHandler::OnHiddenClassIdSelectors(
-    base::Value::Dict result) {
+    mojom::HiddenSelectorsPtr result) {
   if (generichide_) {
     return;
   }
@@ -541,19 +521,14 @@ void CosmeticFiltersJSHandler::OnHiddenClassIdSelectors(
   SCOPED_UMA_HISTOGRAM_TIMER_MICROS(
       "Brave.CosmeticFilters.OnHiddenClassIdSelectors");
   TRACE_EVENT1("brave.adblock", "OnHiddenClassIdSelectors", "url", url_.spec());
+  UMA_HISTOGRAM_COUNTS_1000(
+      "Brave.CosmeticFilters.HiddenClassIdSelectorsResults",
+      result->hide_selectors.size() + result->force_hide_selectors.size());
 
-  base::Value::List* hide_selectors = result.FindList("hide_selectors");
-  DCHECK(hide_selectors);
-
-  base::Value::List* force_hide_selectors =
-      result.FindList("force_hide_selectors");
-  DCHECK(force_hide_selectors);
-
-  if (force_hide_selectors->size() != 0) {
+  if (!result->force_hide_selectors.empty()) {
     std::string stylesheet = "";
-    for (auto& selector : *force_hide_selectors) {
-      DCHECK(selector.is_string());
-      stylesheet += selector.GetString() + "{display:none !important}";
+    for (const auto& selector : result->force_hide_selectors) {
+      stylesheet += selector + "{display:none !important}";
     }
     InjectStylesheet(stylesheet);
   }
@@ -565,22 +540,17 @@ void CosmeticFiltersJSHandler::OnHiddenClassIdSelectors(
 
   if (enabled_1st_party_cf_) {
     std::string stylesheet = "";
-    for (auto& selector : *hide_selectors) {
-      DCHECK(selector.is_string());
-      stylesheet += selector.GetString() + "{display:none !important}";
+    for (const auto& selector : result->hide_selectors) {
+      stylesheet += selector + "{display:none !important}";
     }
     InjectStylesheet(stylesheet);
   } else {
     blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
-    std::string json_selectors;
-    if (!base::JSONWriter::Write(*hide_selectors, &json_selectors) ||
-        json_selectors.empty()) {
-      json_selectors = "[]";
-    }
-    // Building a script for stylesheet modifications
-    std::string new_selectors_script =
-        base::StringPrintf(kHideSelectorsInjectScript, json_selectors.c_str());
-    if (hide_selectors->size() != 0) {
+    if (!result->hide_selectors.empty()) {
+      // Building a script for stylesheet modifications
+      std::string new_selectors_script = base::StringPrintf(
+          kHideSelectorsInjectScript,
+          SerializeSelectors(result->hide_selectors).c_str());
       web_frame->ExecuteScriptInIsolatedWorld(
           isolated_world_id_,
           blink::WebScriptSource(
@@ -593,9 +563,20 @@ void CosmeticFiltersJSHandler::OnHiddenClassIdSelectors(
   }
 }
 
+void CosmeticFiltersJSHandler::RecordPageMetrics() {
+  if (page_observed_) {
+    UMA_HISTOGRAM_COUNTS_1000(
+        "Brave.CosmeticFilters.HiddenClassIdSelectorsRequests",
+        hidden_class_id_requests_);
+  }
+  page_observed_ = false;
+  hidden_class_id_requests_ = 0;
+}
+
 void CosmeticFiltersJSHandler::ExecuteObservingBundleEntryPoint() {
   blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
   DCHECK(web_frame);
+  page_observed_ = true;
 
   if (!bundle_injected_) {
     SCOPED_UMA_HISTOGRAM_TIMER_MICROS(
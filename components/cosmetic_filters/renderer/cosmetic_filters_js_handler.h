@@ -16,7 +16,6 @@
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
 #include "mojo/public/cpp/bindings/remote.h"
-#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
 #include "v8/include/v8.h"
 
@@ -35,10 +34,13 @@ class CosmeticFiltersJSHandler {
   // Adds the "cf_worker" JavaScript object and its functions to the current
   // render_frame_.
   void AddJavaScriptObjectToFrame(v8::Local<v8::Context> context);
-  // Fetches an initial set of resources to inject into the page if cosmetic
-  // filtering is enabled, and returns whether or not to proceed with cosmetic
-  // filtering.
-  bool ProcessURL(const GURL& url, absl::optional<base::OnceClosure> callback);
+  // Returns whether or not to proceed with cosmetic filtering for the URL.
+  // The initial set of resources to inject into the page then has to be
+  // loaded, or set once pushed by the browser.
+  bool ProcessURL(const GURL& url);
+  void LoadUrlCosmeticResources(base::OnceClosure callback);
+  void LoadUrlCosmeticResourcesSync();
+  void SetUrlCosmeticResources(mojom::UrlCosmeticResourcesPtr resources);
   void ApplyRules(bool de_amp_enabled);
 
  private:
@@ -59,18 +61,23 @@ class CosmeticFiltersJSHandler {
 
   void CreateWorkerObject(v8::Isolate* isolate, v8::Local<v8::Context> context);
 
-  // A function to be called from JS
-  void HiddenClassIdSelectors(const std::string& input);
+  // A function to be called from JS, with the classes and ids which haven't
+  // been looked up yet on the page.
+  void HiddenClassIdSelectors(const std::vector<std::string>& classes,
+                              const std::vector<std::string>& ids);
 
   void OnUrlCosmeticResources(base::OnceClosure callback,
-                              base::Value result);
-  void CSSRulesRoutine(const base::Value::Dict& resources_dict);
-  void OnHiddenClassIdSelectors(base::Value::Dict result);
+                              mojom::UrlCosmeticResourcesPtr resources);
+  void CSSRulesRoutine(const mojom::UrlCosmeticResources& resources);
+  void OnHiddenClassIdSelectors(mojom::HiddenSelectorsPtr result);
   bool OnIsFirstParty(const std::string& url_string);
   int OnEventBegin(const std::string& event_name);
   void OnEventEnd(const std::string& event_name, int);
 
   void InjectStylesheet(const std::string& stylesheet);
+  // Records how many class and id lookups the page which was last observed
+  // made, and resets the count.
+  void RecordPageMetrics();
 
   bool generichide_ = false;
 
@@ -81,10 +88,13 @@ class CosmeticFiltersJSHandler {
   bool enabled_1st_party_cf_;
   std::vector<std::string> exceptions_;
   GURL url_;
-  absl::optional<base::Value::Dict> resources_dict_;
+  mojom::UrlCosmeticResourcesPtr resources_;
 
   // True if the content_cosmetic.bundle.js has injected in the current frame.
   bool bundle_injected_ = false;
+  // True once the observing bundle has run for the current page.
+  bool page_observed_ = false;
+  int hidden_class_id_requests_ = 0;
 
   std::unique_ptr<class CosmeticFilterPerfTracker> perf_tracker_;
 
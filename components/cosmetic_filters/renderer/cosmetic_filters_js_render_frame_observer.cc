@@ -10,10 +10,12 @@
 
 #include "base/bind.h"
 #include "base/feature_list.h"
+#include "base/metrics/histogram_macros.h"
 #include "brave/components/brave_shields/common/features.h"
 #include "brave/components/de_amp/common/features.h"
 #include "content/public/renderer/render_frame.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
+#include "third_party/blink/public/common/associated_interfaces/associated_interface_registry.h"
 #include "third_party/blink/public/platform/web_isolated_world_info.h"
 #include "third_party/blink/public/platform/web_url.h"
 #include "third_party/blink/public/web/web_local_frame.h"
@@ -24,6 +26,11 @@ namespace {
 
 const char kSecurityOrigin[] = "chrome://cosmetic_filters";
 
+// How long a frame waits for resources which the browser said it would push
+// before asking for them itself. Announcements older than this are also
+// dropped, as they can arrive after the navigation they were sent for.
+constexpr base::TimeDelta kPushTimeout = base::Seconds(1);
+
 void EnsureIsolatedWorldInitialized(int world_id) {
   static absl::optional<int> last_used_world_id;
   if (last_used_world_id) {
@@ -61,7 +68,12 @@ CosmeticFiltersJsRenderFrameObserver::CosmeticFiltersJsRenderFrameObserver(
       native_javascript_handle_(
           new CosmeticFiltersJSHandler(render_frame, isolated_world_id)),
       get_de_amp_enabled_closure_(std::move(get_de_amp_enabled_closure)),
-      ready_(new base::OneShotEvent()) {}
+      ready_(new base::OneShotEvent()) {
+  render_frame->GetAssociatedInterfaceRegistry()
+      ->AddInterface<mojom::CosmeticFiltersAgent>(base::BindRepeating(
+          &CosmeticFiltersJsRenderFrameObserver::BindCosmeticFiltersAgent,
+          base::Unretained(this)));
+}
 
 CosmeticFiltersJsRenderFrameObserver::~CosmeticFiltersJsRenderFrameObserver() =
     default;
@@ -75,10 +87,24 @@ void CosmeticFiltersJsRenderFrameObserver::DidStartNavigation(
 void CosmeticFiltersJsRenderFrameObserver::ReadyToCommitNavigation(
     blink::WebDocumentLoader* document_loader) {
   ready_ = std::make_unique<base::OneShotEvent>();
+  awaited_push_token_ = base::UnguessableToken();
+  push_timeout_timer_.Stop();
   // invalidate weak pointers on navigation so we don't get callbacks from the
   // previous url load
   weak_factory_.InvalidateWeakPtrs();
 
+  // Resources pushed by the browser are only used if they are for this URL,
+  // which isn't the case if the navigation has been redirected since the
+  // renderer started it, or if the browser's message didn't arrive before
+  // this navigation and is left over from an earlier one.
+  const GURL pushed_url = std::exchange(pushed_url_, GURL());
+  const base::UnguessableToken push_token =
+      std::exchange(push_token_, base::UnguessableToken());
+  auto pushed_resources = std::exchange(pushed_resources_, absl::nullopt);
+  const bool use_push =
+      !pushed_url.is_empty() &&
+      base::TimeTicks::Now() - push_announced_at_ <= kPushTimeout;
+
   // There could be empty, invalid and "about:blank" URLs,
   // they should fallback to the main frame rules
   if (url_.is_empty() || !url_.is_valid() || url_.spec() == "about:blank")
@@ -88,19 +114,82 @@ void CosmeticFiltersJsRenderFrameObserver::ReadyToCommitNavigation(
   if (!url_.SchemeIsHTTPOrHTTPS())
     return;
 
+  // Time spent on the main thread before the navigation can go on.
+  SCOPED_UMA_HISTOGRAM_TIMER_MICROS("Brave.CosmeticFilters.ProcessURL");
+  if (!native_javascript_handle_->ProcessURL(url_))
+    return;
+
   if (base::FeatureList::IsEnabled(
           ::brave_shields::features::kCosmeticFilteringSyncLoad)) {
-    if (native_javascript_handle_->ProcessURL(url_, absl::nullopt)) {
+    native_javascript_handle_->LoadUrlCosmeticResourcesSync();
+    ready_->Signal();
+  } else if (use_push && pushed_url == url_) {
+    if (pushed_resources) {
+      native_javascript_handle_->SetUrlCosmeticResources(
+          std::move(*pushed_resources));
       ready_->Signal();
+    } else {
+      awaited_push_token_ = push_token;
+      push_timeout_timer_.Start(
+          FROM_HERE, kPushTimeout,
+          base::BindOnce(&CosmeticFiltersJsRenderFrameObserver::
+                             FallBackToLoadUrlCosmeticResources,
+                         base::Unretained(this)));
     }
   } else {
-    native_javascript_handle_->ProcessURL(
-        url_, absl::make_optional(base::BindOnce(
-                  &CosmeticFiltersJsRenderFrameObserver::OnProcessURL,
-                  weak_factory_.GetWeakPtr())));
+    native_javascript_handle_->LoadUrlCosmeticResources(
+        base::BindOnce(&CosmeticFiltersJsRenderFrameObserver::OnProcessURL,
+                       weak_factory_.GetWeakPtr()));
   }
 }
 
+void CosmeticFiltersJsRenderFrameObserver::WillSendUrlCosmeticResources(
+    const std::string& url,
+    const base::UnguessableToken& token) {
+  pushed_url_ = GURL(url);
+  push_token_ = token;
+  push_announced_at_ = base::TimeTicks::Now();
+  pushed_resources_.reset();
+}
+
+void CosmeticFiltersJsRenderFrameObserver::SetUrlCosmeticResources(
+    const base::UnguessableToken& token,
+    mojom::UrlCosmeticResourcesPtr resources) {
+  if (!awaited_push_token_.is_empty() && token == awaited_push_token_) {
+    awaited_push_token_ = base::UnguessableToken();
+    push_timeout_timer_.Stop();
+    native_javascript_handle_->SetUrlCosmeticResources(std::move(resources));
+    ready_->Signal();
+    return;
+  }
+
+  if (!push_token_.is_empty() && token == push_token_) {
+    // The navigation isn't ready to commit in this frame yet.
+    pushed_resources_ = std::move(resources);
+  }
+
+  // Otherwise the lookup has been replaced by a later one, or the frame has
+  // asked for the resources itself.
+}
+
+void CosmeticFiltersJsRenderFrameObserver::
+    FallBackToLoadUrlCosmeticResources() {
+  if (awaited_push_token_.is_empty())
+    return;
+
+  awaited_push_token_ = base::UnguessableToken();
+  push_timeout_timer_.Stop();
+  native_javascript_handle_->LoadUrlCosmeticResources(
+      base::BindOnce(&CosmeticFiltersJsRenderFrameObserver::OnProcessURL,
+                     weak_factory_.GetWeakPtr()));
+}
+
+void CosmeticFiltersJsRenderFrameObserver::BindCosmeticFiltersAgent(
+    mojo::PendingAssociatedReceiver<mojom::CosmeticFiltersAgent> receiver) {
+  agent_receiver_.reset();
+  agent_receiver_.Bind(std::move(receiver));
+}
+
 void CosmeticFiltersJsRenderFrameObserver::RunScriptsAtDocumentStart() {
   if (ready_->is_signaled()) {
     ApplyRules();
@@ -138,6 +227,12 @@ void CosmeticFiltersJsRenderFrameObserver::DidCreateNewDocument() {
   EnsureIsolatedWorldInitialized(isolated_world_id_);
 }
 
+void CosmeticFiltersJsRenderFrameObserver::DidFinishDocumentLoad() {
+  // The rules are held back until the resources arrive, so don't wait for
+  // them any longer than the document itself.
+  FallBackToLoadUrlCosmeticResources();
+}
+
 void CosmeticFiltersJsRenderFrameObserver::OnDestruct() {
   delete this;
 }
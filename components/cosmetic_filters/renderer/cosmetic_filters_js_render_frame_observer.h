@@ -7,13 +7,20 @@
 #define BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_COSMETIC_FILTERS_JS_RENDER_FRAME_OBSERVER_H_
 
 #include <memory>
+#include <string>
 
 #include "base/memory/weak_ptr.h"
 #include "base/one_shot_event.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "base/unguessable_token.h"
+#include "brave/components/cosmetic_filters/common/cosmetic_filters.mojom.h"
 #include "brave/components/cosmetic_filters/renderer/cosmetic_filters_js_handler.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
 #include "content/public/renderer/render_frame_observer_tracker.h"
+#include "mojo/public/cpp/bindings/associated_receiver.h"
+#include "mojo/public/cpp/bindings/pending_associated_receiver.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/blink/public/web/web_navigation_type.h"
 #include "url/gurl.h"
@@ -26,7 +33,8 @@ namespace cosmetic_filters {
 class CosmeticFiltersJsRenderFrameObserver
     : public content::RenderFrameObserver,
       public content::RenderFrameObserverTracker<
-          CosmeticFiltersJsRenderFrameObserver> {
+          CosmeticFiltersJsRenderFrameObserver>,
+      public mojom::CosmeticFiltersAgent {
  public:
   CosmeticFiltersJsRenderFrameObserver(
       content::RenderFrame* render_frame,
@@ -49,11 +57,24 @@ class CosmeticFiltersJsRenderFrameObserver
   void DidCreateScriptContext(v8::Local<v8::Context> context,
                               int32_t world_id) override;
   void DidCreateNewDocument() override;
+  void DidFinishDocumentLoad() override;
 
   void RunScriptsAtDocumentStart();
 
+  // mojom::CosmeticFiltersAgent implementation.
+  void WillSendUrlCosmeticResources(
+      const std::string& url,
+      const base::UnguessableToken& token) override;
+  void SetUrlCosmeticResources(
+      const base::UnguessableToken& token,
+      mojom::UrlCosmeticResourcesPtr resources) override;
+
  private:
+  void BindCosmeticFiltersAgent(
+      mojo::PendingAssociatedReceiver<mojom::CosmeticFiltersAgent> receiver);
   void OnProcessURL();
+  // Asks for the resources if they still haven't been pushed.
+  void FallBackToLoadUrlCosmeticResources();
   void ApplyRules();
 
   // RenderFrameObserver implementation.
@@ -70,6 +91,20 @@ class CosmeticFiltersJsRenderFrameObserver
 
   std::unique_ptr<base::OneShotEvent> ready_;
 
+  // The lookup the browser last told the frame about, and its resources once
+  // they have been pushed, until the next navigation is ready to commit.
+  GURL pushed_url_;
+  base::UnguessableToken push_token_;
+  base::TimeTicks push_announced_at_;
+  absl::optional<mojom::UrlCosmeticResourcesPtr> pushed_resources_;
+
+  // The lookup which signals `ready_` once its resources are pushed, empty if
+  // the current document doesn't wait for one.
+  base::UnguessableToken awaited_push_token_;
+  base::OneShotTimer push_timeout_timer_;
+
+  mojo::AssociatedReceiver<mojom::CosmeticFiltersAgent> agent_receiver_{this};
+
   base::WeakPtrFactory<CosmeticFiltersJsRenderFrameObserver> weak_factory_{
       this};
 };
@@ -36,6 +36,9 @@ let currentMutationStartTime = performance.now()
 // The next allowed time to call FetchNewClassIdRules() if it's throttled.
 let nextFetchNewClassIdRulesCall = 0
 let fetchNewClassIdRulesTimeoutId: number | undefined
+// Set while a fetch is scheduled for the next frame, see
+// scheduleFetchNewClassIdRules().
+let fetchNewClassIdRulesFrameId: number | undefined
 
 const queriedIds = new Set<string>()
 const queriedClasses = new Set<string>()
@@ -150,14 +153,32 @@ const fetchNewClassIdRules = () => {
   }
   // Callback to c++ renderer process
   // @ts-expect-error
-  cf_worker.hiddenClassIdSelectors(
-      JSON.stringify({
-        classes: notYetQueriedClasses, ids: notYetQueriedIds
-      }))
+  cf_worker.hiddenClassIdSelectors(notYetQueriedClasses, notYetQueriedIds)
   notYetQueriedClasses = []
   notYetQueriedIds = []
 }
 
+// Mutations often come in many small batches while a page renders, so the
+// names they add are sent together once per frame rather than once per batch.
+// Hidden documents don't get animation frames, so they fetch right away.
+const scheduleFetchNewClassIdRules = () => {
+  if (fetchNewClassIdRulesFrameId !== undefined) {
+    return
+  }
+  if (document.hidden) {
+    if (!ShouldThrottleFetchNewClassIdsRules()) {
+      fetchNewClassIdRules()
+    }
+    return
+  }
+  fetchNewClassIdRulesFrameId = window.requestAnimationFrame(() => {
+    fetchNewClassIdRulesFrameId = undefined
+    if (!ShouldThrottleFetchNewClassIdsRules()) {
+      fetchNewClassIdRules()
+    }
+  })
+}
+
 const useMutationObserver = () => {
   if (selectorsPollingIntervalId) {
     clearInterval(selectorsPollingIntervalId)
@@ -211,7 +232,7 @@ const queueAttrsFromMutations = (mutations: MutationRecord[]): number => {
         case 'id':
           const mutatedId = changedElm.id
           mutationScore++
-          if (!queriedIds.has(mutatedId)) {
+          if (mutatedId && !queriedIds.has(mutatedId)) {
             notYetQueriedIds.push(mutatedId)
             queriedIds.add(mutatedId)
           }
@@ -268,9 +289,7 @@ const onMutations = (mutations: MutationRecord[], observer: MutationObserver) =>
     }
   }
 
-  if (!ShouldThrottleFetchNewClassIdsRules()) {
-    fetchNewClassIdRules()
-  }
+  scheduleFetchNewClassIdRules()
 
   if (eventId) {
     // Callback to c++ renderer process
@@ -11,7 +11,6 @@
 #include "base/base_paths.h"
 #include "base/bind.h"
 #include "base/command_line.h"
-#include "base/containers/flat_set.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/task/thread_pool.h"
@@ -28,6 +27,18 @@ namespace debounce {
 const char kDebounceConfigFile[] = "debounce.json";
 const char kDebounceConfigFileVersion[] = "1";
 
+namespace {
+
+// Parsing compiles the regexes of the rules, so it happens on the thread pool
+// along with reading the file.
+DebounceRule::ParsedRules ReadAndParseRules(
+    const base::FilePath& dat_file_path) {
+  return DebounceRule::ParseRules(
+      brave_component_updater::GetDATFileAsString(dat_file_path));
+}
+
+}  // namespace
+
 DebounceComponentInstaller::DebounceComponentInstaller(
     LocalDataFilesService* local_data_files_service)
     : LocalDataFilesObserver(local_data_files_service) {}
@@ -38,23 +49,19 @@ void DebounceComponentInstaller::LoadDirectlyFromResourcePath() {
   base::FilePath dat_file_path = resource_dir_.AppendASCII(kDebounceConfigFile);
   base::ThreadPool::PostTaskAndReplyWithResult(
       FROM_HERE, {base::MayBlock()},
-      base::BindOnce(&brave_component_updater::GetDATFileAsString,
-                     dat_file_path),
-      base::BindOnce(&DebounceComponentInstaller::OnDATFileDataReady,
+      base::BindOnce(&ReadAndParseRules, dat_file_path),
+      base::BindOnce(&DebounceComponentInstaller::OnRulesParsed,
                      weak_factory_.GetWeakPtr()));
 }
 
-void DebounceComponentInstaller::OnDATFileDataReady(
-    const std::string& contents) {
-  auto parsed_rules = DebounceRule::ParseRules(contents);
+void DebounceComponentInstaller::OnRulesParsed(
+    DebounceRule::ParsedRules parsed_rules) {
   if (!parsed_rules.has_value()) {
     LOG(WARNING) << parsed_rules.error();
     return;
   }
-  rules_.clear();
-  host_cache_.clear();
   rules_ = std::move(parsed_rules.value().first);
-  host_cache_ = parsed_rules.value().second;
+  rule_index_ = std::move(parsed_rules.value().second);
   for (Observer& observer : observers_)
     observer.OnRulesReady(this);
 }
@@ -10,7 +10,6 @@
 #include <string>
 #include <vector>
 
-#include "base/containers/flat_set.h"
 #include "base/files/file_path.h"
 #include "base/json/json_value_converter.h"
 #include "base/memory/weak_ptr.h"
@@ -44,7 +43,7 @@ class DebounceComponentInstaller
   const std::vector<std::unique_ptr<DebounceRule>>& rules() const {
     return rules_;
   }
-  const base::flat_set<std::string>& host_cache() const { return host_cache_; }
+  const DebounceRuleIndex& rule_index() const { return rule_index_; }
 
   // implementation of brave_component_updater::LocalDataFilesObserver
   void OnComponentReady(const std::string& component_id,
@@ -65,13 +64,13 @@ class DebounceComponentInstaller
  private:
   friend class DebounceBrowserTest;
 
-  void OnDATFileDataReady(const std::string& contents);
+  void OnRulesParsed(DebounceRule::ParsedRules parsed_rules);
   void LoadOnTaskRunner();
   void LoadDirectlyFromResourcePath();
 
   base::ObserverList<Observer> observers_;
   std::vector<std::unique_ptr<DebounceRule>> rules_;
-  base::flat_set<std::string> host_cache_;
+  DebounceRuleIndex rule_index_;
   base::FilePath resource_dir_;
 
   base::WeakPtrFactory<DebounceComponentInstaller> weak_factory_{this};
@@ -5,6 +5,9 @@
 
 #include "brave/components/debounce/browser/debounce_rule.h"
 
+#include <algorithm>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -128,10 +131,8 @@ bool DebounceRule::IsSameETLDForDebounce(const GURL& url1, const GURL& url2) {
 }
 
 // static
-base::expected<std::pair<std::vector<std::unique_ptr<DebounceRule>>,
-                         base::flat_set<std::string>>,
-               std::string>
-DebounceRule::ParseRules(const std::string& contents) {
+DebounceRule::ParsedRules DebounceRule::ParseRules(
+    const std::string& contents) {
   if (contents.empty()) {
     return base::unexpected("Could not obtain debounce configuration");
   }
@@ -139,25 +140,77 @@ DebounceRule::ParseRules(const std::string& contents) {
   if (!root) {
     return base::unexpected("Failed to parse debounce configuration");
   }
-  std::vector<std::string> hosts;
+  std::map<std::string, std::vector<size_t>> rules_by_host;
+  std::vector<size_t> any_host_rules;
   std::vector<std::unique_ptr<DebounceRule>> rules;
   base::JSONValueConverter<DebounceRule> converter;
   for (base::Value& it : root->GetList()) {
     std::unique_ptr<DebounceRule> rule = std::make_unique<DebounceRule>();
     if (!converter.Convert(it, rule.get()))
       continue;
+    rule->CompileParamRegex();
+
+    const size_t rule_index = rules.size();
+    bool matches_any_host = false;
     for (const URLPattern& pattern : rule->include_pattern_set()) {
-      if (!pattern.host().empty()) {
-        const std::string etldp1 =
-            DebounceRule::GetETLDForDebounce(pattern.host());
-        if (!etldp1.empty())
-          hosts.push_back(std::move(etldp1));
+      const std::string etldp1 =
+          pattern.host().empty()
+              ? std::string()
+              : DebounceRule::GetETLDForDebounce(pattern.host());
+      if (etldp1.empty()) {
+        matches_any_host = true;
+        continue;
       }
+      std::vector<size_t>& host_rules = rules_by_host[etldp1];
+      if (host_rules.empty() || host_rules.back() != rule_index)
+        host_rules.push_back(rule_index);
     }
+    if (matches_any_host)
+      any_host_rules.push_back(rule_index);
     rules.push_back(std::move(rule));
   }
+
+  // Rules used to be tried in order for any URL on one of the indexed eTLD+1s,
+  // so keep that order when merging in the rules which match any host.
+  std::vector<std::pair<std::string, std::vector<size_t>>> index;
+  index.reserve(rules_by_host.size());
+  for (auto& [etldp1, host_rules] : rules_by_host) {
+    std::vector<size_t> candidates;
+    candidates.reserve(host_rules.size() + any_host_rules.size());
+    std::set_union(host_rules.begin(), host_rules.end(),
+                   any_host_rules.begin(), any_host_rules.end(),
+                   std::back_inserter(candidates));
+    index.emplace_back(etldp1, std::move(candidates));
+  }
   return std::pair<std::vector<std::unique_ptr<DebounceRule>>,
-                   base::flat_set<std::string>>(std::move(rules), hosts);
+                   DebounceRuleIndex>(
+      std::move(rules),
+      DebounceRuleIndex(base::sorted_unique, std::move(index)));
+}
+
+void DebounceRule::CompileParamRegex() {
+  if (action_ != kDebounceRegexPath)
+    return;
+  if (param_.length() > kMaxLengthRegexPattern) {
+    VLOG(1) << "Debounce regex pattern exceeds max length: "
+            << kMaxLengthRegexPattern;
+    return;
+  }
+  re2::RE2::Options options;
+  options.set_max_mem(kMaxMemoryPerRegexPattern);
+  auto param_regex = std::make_unique<re2::RE2>(param_, options);
+
+  if (!param_regex->ok()) {
+    VLOG(1) << "Debounce rule has param: " << param_
+            << " which is an invalid regex pattern";
+    return;
+  }
+  if (param_regex->NumberOfCapturingGroups() < 1) {
+    VLOG(1) << "Debounce rule has param: " << param_
+            << " which captures < 1 groups";
+    return;
+  }
+  param_regex_ = std::move(param_regex);
 }
 
 bool DebounceRule::CheckPrefForRule(const PrefService* prefs) const {
@@ -177,29 +230,12 @@ bool DebounceRule::CheckPrefForRule(const PrefService* prefs) const {
   return true;
 }
 
-bool DebounceRule::ValidateAndParsePatternRegex(
-    const std::string& pattern,
-    const std::string& path,
-    std::string* parsed_value) const {
-  if (pattern.length() > kMaxLengthRegexPattern) {
-    VLOG(1) << "Debounce regex pattern exceeds max length: "
-            << kMaxLengthRegexPattern;
+bool DebounceRule::ParsePatternRegex(const std::string& path,
+                                     std::string* parsed_value) const {
+  // Invalid patterns were logged when the rule was parsed.
+  if (!param_regex_)
     return false;
-  }
-  re2::RE2::Options options;
-  options.set_max_mem(kMaxMemoryPerRegexPattern);
-  const re2::RE2 pattern_regex(pattern, options);
-
-  if (!pattern_regex.ok()) {
-    VLOG(1) << "Debounce rule has param: " << pattern
-            << " which is an invalid regex pattern";
-    return false;
-  }
-  if (pattern_regex.NumberOfCapturingGroups() < 1) {
-    VLOG(1) << "Debounce rule has param: " << pattern
-            << " which captures < 1 groups";
-    return false;
-  }
+  const re2::RE2& pattern_regex = *param_regex_;
 
   // Get matching capture groups by applying regex to the path
   size_t number_of_capturing_groups =
@@ -258,7 +294,7 @@ bool DebounceRule::Apply(const GURL& original_url,
     // Important: Apply param regex to ONLY the path of original URL.
     auto path = original_url.path();
 
-    if (!ValidateAndParsePatternRegex(param_, path, &unescaped_value)) {
+    if (!ParsePatternRegex(path, &unescaped_value)) {
       VLOG(1) << "Debounce regex parsing failed";
       return false;
     }
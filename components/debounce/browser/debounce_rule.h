@@ -11,7 +11,7 @@
 #include <utility>
 #include <vector>
 
-#include "base/containers/flat_set.h"
+#include "base/containers/flat_map.h"
 #include "base/json/json_value_converter.h"
 #include "base/strings/escape.h"
 #include "base/types/expected.h"
@@ -21,8 +21,17 @@
 
 class GURL;
 
+namespace re2 {
+class RE2;
+}  // namespace re2
+
 namespace debounce {
 
+// Maps the eTLD+1 of the hosts in the rules' include patterns to the indices,
+// in rule order, of the rules which can apply to URLs on that eTLD+1. Rules
+// whose include patterns match any host are listed under every eTLD+1.
+using DebounceRuleIndex = base::flat_map<std::string, std::vector<size_t>>;
+
 enum DebounceAction {
   kDebounceNoAction,
   kDebounceRedirectToParam,
@@ -38,6 +47,11 @@ enum DebouncePrependScheme {
 
 class DebounceRule {
  public:
+  using ParsedRules =
+      base::expected<std::pair<std::vector<std::unique_ptr<DebounceRule>>,
+                               DebounceRuleIndex>,
+                     std::string>;
+
   DebounceRule();
   ~DebounceRule();
 
@@ -49,10 +63,7 @@ class DebounceRule {
                                   DebounceAction* field);
   static bool ParsePrependScheme(base::StringPiece value,
                                  DebouncePrependScheme* field);
-  static base::expected<std::pair<std::vector<std::unique_ptr<DebounceRule>>,
-                                  base::flat_set<std::string>>,
-                        std::string>
-  ParseRules(const std::string& contents);
+  static ParsedRules ParseRules(const std::string& contents);
   static const std::string GetETLDForDebounce(const std::string& host);
   static bool IsSameETLDForDebounce(const GURL& url1, const GURL& url2);
   static bool GetURLPatternSetFromValue(const base::Value* value,
@@ -67,15 +78,18 @@ class DebounceRule {
 
  private:
   bool CheckPrefForRule(const PrefService* prefs) const;
-  bool ValidateAndParsePatternRegex(const std::string& pattern,
-                                    const std::string& path,
-                                    std::string* parsed_value) const;
+  // Compiles `param_` for regex-path rules, leaving `param_regex_` null if it
+  // is not a valid pattern.
+  void CompileParamRegex();
+  bool ParsePatternRegex(const std::string& path,
+                         std::string* parsed_value) const;
   extensions::URLPatternSet include_pattern_set_;
   extensions::URLPatternSet exclude_pattern_set_;
   DebounceAction action_;
   DebouncePrependScheme prepend_scheme_;
   std::string param_;
   std::string pref_;
+  std::unique_ptr<re2::RE2> param_regex_;
 };
 
 }  // namespace debounce
@@ -9,8 +9,6 @@
 #include <string>
 #include <vector>
 
-#include "base/containers/contains.h"
-#include "base/containers/flat_set.h"
 #include "base/logging.h"
 #include "brave/components/debounce/browser/debounce_component_installer.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
@@ -27,19 +25,19 @@ DebounceService::~DebounceService() = default;
 
 bool DebounceService::Debounce(const GURL& original_url,
                                GURL* final_url) const {
-  // Check host cache to see if this URL needs to have any debounce rules
-  // applied.
-  const base::flat_set<std::string>& host_cache =
-      component_installer_->host_cache();
-  const std::string etldp1 =
-      DebounceRule::GetETLDForDebounce(original_url.host());
-  if (!base::Contains(host_cache, etldp1))
+  // Check the rule index to see if this URL needs to have any debounce rules
+  // applied, and which ones.
+  const DebounceRuleIndex& index = component_installer_->rule_index();
+  const auto candidates =
+      index.find(DebounceRule::GetETLDForDebounce(original_url.host()));
+  if (candidates == index.end())
     return false;
 
   const std::vector<std::unique_ptr<DebounceRule>>& rules =
       component_installer_->rules();
 
-  for (const std::unique_ptr<DebounceRule>& rule : rules) {
+  for (size_t i : candidates->second) {
+    const std::unique_ptr<DebounceRule>& rule = rules[i];
     if (rule->Apply(original_url, final_url, prefs_)) {
       if (original_url != *final_url) {
         return true;
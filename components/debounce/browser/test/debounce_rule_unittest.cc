@@ -4,10 +4,15 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "brave/components/debounce/browser/debounce_rule.h"
+#include "base/containers/contains.h"
 #include "base/json/json_reader.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/testing_pref_service.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 #include "url/gurl.h"
 
@@ -445,4 +450,141 @@ TEST(DebounceRuleUnitTest, CatchMultiplePathsForSameInclude) {
   }
 }
 
+TEST(DebounceRuleUnitTest, IndexesRulesByIncludeHost) {
+  const std::string contents = R"json(
+
+      [{
+          "include": [
+              "*://a.com/*"
+          ],
+          "exclude": [],
+          "action": "redirect",
+          "param": "url"
+      }, {
+          "include": [
+              "*://*/*"
+          ],
+          "exclude": [],
+          "action": "redirect",
+          "param": "url"
+      }, {
+          "include": [
+              "*://*.b.com/*",
+              "*://tracker.a.com/*"
+          ],
+          "exclude": [],
+          "action": "regex-path",
+          "param": "^/(.*)$"
+      }]
+
+    )json";
+  auto parsed = DebounceRule::ParseRules(contents);
+  ASSERT_TRUE(parsed.has_value());
+  const DebounceRuleIndex& index = parsed.value().second;
+
+  // Rules which match any host are candidates for every indexed eTLD+1, in
+  // their original order.
+  ASSERT_EQ(2u, index.size());
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2}), index.at("a.com"));
+  EXPECT_EQ(std::vector<size_t>({1, 2}), index.at("b.com"));
+}
+
+TEST(DebounceRuleUnitTest, BenchmarkDebounce) {
+  // The rules are modelled on the shipped debounce.json: mostly query
+  // parameter redirects and some regex-path rules, each on its own tracker.
+  constexpr size_t kRuleCount = 1000;
+  constexpr size_t kNavigationCount = 10000;
+
+  std::string contents = "[";
+  for (size_t i = 0; i < kRuleCount; i++) {
+    if (i > 0)
+      contents += ",";
+    if (i % 4 == 0) {
+      contents += base::StringPrintf(
+          R"json({"include": ["*://*.tracker%zu.com/c/*"], "exclude": [],
+              "action": "regex-path", "prepend_scheme": "https",
+              "param": "^/c/[0-9]+/(.*)$"})json",
+          i);
+    } else {
+      contents += base::StringPrintf(
+          R"json({"include": ["*://tracker%zu.com/*"], "exclude": [],
+              "action": "redirect", "param": "url"})json",
+          i);
+    }
+  }
+  contents += "]";
+  auto parsed = DebounceRule::ParseRules(contents);
+  ASSERT_TRUE(parsed.has_value());
+  const std::vector<std::unique_ptr<DebounceRule>>& rules =
+      parsed.value().first;
+  const DebounceRuleIndex& index = parsed.value().second;
+  ASSERT_EQ(kRuleCount, rules.size());
+
+  // A navigation log in which one navigation in ten goes through a tracker,
+  // half of those through a rule it doesn't match.
+  std::vector<GURL> navigations;
+  for (size_t i = 0; i < kNavigationCount; i++) {
+    const size_t rule = (i * 7) % kRuleCount;
+    if (i % 20 == 0) {
+      navigations.emplace_back(base::StringPrintf(
+          rule % 4 == 0 ? "https://www.tracker%zu.com/c/1/brave.com/"
+                        : "https://tracker%zu.com/?url=https://brave.com/",
+          rule));
+    } else if (i % 20 == 1) {
+      navigations.emplace_back(
+          base::StringPrintf("https://tracker%zu.com/other", rule));
+    } else {
+      navigations.emplace_back(
+          base::StringPrintf("https://site%zu.com/page", i % 500));
+    }
+  }
+
+  TestingPrefServiceSimple prefs;
+  size_t linear_scan_count = 0;
+  size_t indexed_count = 0;
+
+  // What debouncing used to do: try every rule once the eTLD+1 is known to
+  // have some.
+  const base::TimeTicks linear_scan_start = base::TimeTicks::Now();
+  for (const GURL& url : navigations) {
+    if (!base::Contains(index, DebounceRule::GetETLDForDebounce(url.host())))
+      continue;
+    for (const std::unique_ptr<DebounceRule>& rule : rules) {
+      GURL final_url;
+      if (rule->Apply(url, &final_url, &prefs)) {
+        linear_scan_count++;
+        break;
+      }
+    }
+  }
+  const base::TimeDelta linear_scan_time =
+      base::TimeTicks::Now() - linear_scan_start;
+
+  const base::TimeTicks indexed_start = base::TimeTicks::Now();
+  for (const GURL& url : navigations) {
+    const auto candidates =
+        index.find(DebounceRule::GetETLDForDebounce(url.host()));
+    if (candidates == index.end())
+      continue;
+    for (size_t i : candidates->second) {
+      GURL final_url;
+      if (rules[i]->Apply(url, &final_url, &prefs)) {
+        indexed_count++;
+        break;
+      }
+    }
+  }
+  const base::TimeDelta indexed_time = base::TimeTicks::Now() - indexed_start;
+
+  EXPECT_EQ(kNavigationCount / 20, indexed_count);
+  EXPECT_EQ(linear_scan_count, indexed_count);
+
+  perf_test::PerfResultReporter reporter(
+      "DebounceRule", base::NumberToString(kNavigationCount) + "_navigations");
+  reporter.RegisterImportantMetric(".linear_scan", "ms");
+  reporter.RegisterImportantMetric(".indexed", "ms");
+  reporter.AddResult(".linear_scan", linear_scan_time);
+  reporter.AddResult(".indexed", indexed_time);
+}
+
 }  // namespace debounce
@@ -22,6 +22,12 @@ BASE_FEATURE(kSpeedreaderPanelV2,
              "SpeedreaderPanelV2",
              base::FEATURE_ENABLED_BY_DEFAULT);
 
+// Parses pages on a worker sequence as their body arrives, instead of only
+// once the whole body has been received.
+BASE_FEATURE(kSpeedreaderStreamingDistill,
+             "SpeedreaderStreamingDistill",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
 const base::FeatureParam<int> kSpeedreaderMinOutLengthParam{
     &kSpeedreaderFeature, "min_out_length", 1000};
 
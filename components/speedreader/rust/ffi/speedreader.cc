@@ -12,6 +12,34 @@
 
 namespace speedreader {
 
+namespace {
+
+// Returns the length of the longest prefix of `chunk` which doesn't end in the
+// middle of a multi-byte UTF-8 sequence.
+size_t GetCompleteUtf8Length(const char* chunk, size_t chunk_len) {
+  // Sequences are at most 4 bytes long, so the lead byte of an incomplete one
+  // is within the last 3 bytes.
+  for (size_t i = 1; i <= 3 && i <= chunk_len; i++) {
+    const auto byte = static_cast<unsigned char>(chunk[chunk_len - i]);
+    if ((byte & 0xC0) == 0x80) {
+      // Continuation byte, keep looking for the lead byte.
+      continue;
+    }
+    size_t sequence_len = 1;
+    if ((byte & 0xE0) == 0xC0) {
+      sequence_len = 2;
+    } else if ((byte & 0xF0) == 0xE0) {
+      sequence_len = 3;
+    } else if ((byte & 0xF8) == 0xF0) {
+      sequence_len = 4;
+    }
+    return sequence_len > i ? chunk_len - i : chunk_len;
+  }
+  return chunk_len;
+}
+
+}  // namespace
+
 SpeedReader::SpeedReader() : raw_(speedreader_new()) {}
 
 bool SpeedReader::deserialize(const char* data, size_t data_size) {
@@ -94,7 +122,21 @@ void Rewriter::SetContentStyle(const std::string& content_style) {
 
 int Rewriter::Write(const char* chunk, size_t chunk_len) {
   if (!ended_ && !poisoned_) {
-    int ret = rewriter_write(raw_, chunk, chunk_len);
+    std::string joined;
+    if (!pending_input_.empty()) {
+      joined = std::move(pending_input_);
+      joined.append(chunk, chunk_len);
+      chunk = joined.data();
+      chunk_len = joined.size();
+    }
+    // The rewriter only accepts valid UTF-8, so hold back a trailing partial
+    // sequence until the rest of it is written.
+    const size_t complete_len = GetCompleteUtf8Length(chunk, chunk_len);
+    pending_input_.assign(chunk + complete_len, chunk_len - complete_len);
+    if (complete_len == 0) {
+      return 0;
+    }
+    int ret = rewriter_write(raw_, chunk, complete_len);
     if (ret != 0) {
       poisoned_ = true;
     }
@@ -105,6 +147,14 @@ int Rewriter::Write(const char* chunk, size_t chunk_len) {
 }
 
 int Rewriter::End() {
+  if (!pending_input_.empty() && !ended_ && !poisoned_) {
+    // The input ended in the middle of a sequence, let the rewriter reject it.
+    const std::string pending_input = std::move(pending_input_);
+    pending_input_.clear();
+    if (rewriter_write(raw_, pending_input.data(), pending_input.size()) != 0) {
+      poisoned_ = true;
+    }
+  }
   if (!ended_ && !poisoned_) {
     int ret = rewriter_end(raw_);
     ended_ = true;
@@ -63,7 +63,7 @@ class SPEEDREADER_EXPORT Rewriter {
 
   /// Write a new chunk of data (byte array) to the rewriter instance. Does
   /// _not_ need to be a full document and can be called many times with ever
-  /// new chunk of data available.
+  /// new chunk of data available. Chunks may split multi-byte UTF-8 sequences.
   int Write(const char* chunk, size_t chunk_len);
 
   /// Finish processing input and "close" the `Rewriter`. Flushes any input not
@@ -76,6 +76,9 @@ class SPEEDREADER_EXPORT Rewriter {
 
  private:
   std::string output_;
+  // Trailing bytes of the last chunk which didn't form a complete UTF-8
+  // sequence.
+  std::string pending_input_;
   bool ended_;
   bool poisoned_;
   raw_ptr<C_CRewriter> raw_ = nullptr;
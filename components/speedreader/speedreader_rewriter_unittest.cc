@@ -3,6 +3,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <algorithm>
 #include <string>
 
 #include "base/files/file_enumerator.h"
@@ -55,6 +56,22 @@ class SpeedreaderRewriterTestBase : public ::testing::Test {
     return rewriter->GetOutput();
   }
 
+  // Writes the page in chunks of `chunk_size` bytes, as it would arrive from
+  // the network.
+  std::string ProcessPageInChunks(const std::string& file_name,
+                                  size_t chunk_size) {
+    auto rewriter = speedreader_.MakeRewriter("https://test.com");
+    rewriter->SetMinOutLength(100);
+    const auto file_content = GetFileContent(file_name);
+    for (size_t offset = 0; offset < file_content.size();
+         offset += chunk_size) {
+      const size_t length = std::min(chunk_size, file_content.size() - offset);
+      EXPECT_EQ(0, rewriter->Write(file_content.data() + offset, length));
+    }
+    rewriter->End();
+    return rewriter->GetOutput();
+  }
+
   void CheckContent(const std::string& expected_content,
                     const std::string& filename) {
     EXPECT_EQ(GetFileContent(filename), expected_content) << expected_content;
@@ -70,8 +87,10 @@ class SpeedreaderRewriterTestBase : public ::testing::Test {
     return current_process_dir_;
   }
 
- private:
+ protected:
   SpeedReader speedreader_;
+
+ private:
   base::FilePath test_data_dir_;
   base::FilePath current_process_dir_;
 };
@@ -99,6 +118,37 @@ TEST_P(SpeedreaderRewriterTest, Check) {
   CheckContent(out, expected_file);
 }
 
+TEST_P(SpeedreaderRewriterTest, CheckChunked) {
+  base::ScopedAllowBlockingForTesting allow_blocking;
+
+  const std::string input_file = std::string(GetParam()).append(".html");
+  const std::string expected_file =
+      std::string(GetParam()).append(".expected.html");
+
+  // Small odd sizes split the input everywhere, including in the middle of
+  // multi-byte UTF-8 sequences.
+  for (size_t chunk_size : {1u, 3u, 7u, 4096u}) {
+    SCOPED_TRACE(chunk_size);
+    CheckContent(ProcessPageInChunks(input_file, chunk_size), expected_file);
+  }
+}
+
+TEST_F(SpeedreaderRewriterTestBase, SplitUtf8Sequence) {
+  auto rewriter = speedreader_.MakeRewriter("https://test.com");
+  // "ü" and "€" are 2 and 3 byte sequences.
+  const std::string input = "<html><body><p>\xC3\xBC\xE2\x82\xAC</p>";
+  for (char byte : input) {
+    EXPECT_EQ(0, rewriter->Write(&byte, 1));
+  }
+}
+
+TEST_F(SpeedreaderRewriterTestBase, TruncatedUtf8SequenceIsRejected) {
+  auto rewriter = speedreader_.MakeRewriter("https://test.com");
+  const std::string input = "<html><body><p>\xE2\x82";
+  EXPECT_EQ(0, rewriter->Write(input.data(), input.size()));
+  EXPECT_NE(0, rewriter->End());
+}
+
 class SpeedreaderRewriterThemeTest : public SpeedreaderRewriterTestBase {};
 
 TEST_F(SpeedreaderRewriterThemeTest, SetTheme) {
@@ -12,11 +12,13 @@
 #include "base/bind.h"
 #include "base/check.h"
 #include "base/command_line.h"
+#include "base/feature_list.h"
 #include "base/files/file_util.h"
 #include "base/memory/weak_ptr.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool.h"
+#include "brave/components/speedreader/common/features.h"
 #include "brave/components/body_sniffer/body_sniffer_throttle.h"
 #include "brave/components/speedreader/rust/ffi/speedreader.h"
 #include "brave/components/speedreader/speedreader_rewriter_service.h"
@@ -31,13 +33,22 @@ namespace {
 
 constexpr uint32_t kReadBufferSize = 32768;
 
+constexpr const char kCollectSwitch[] = "speedreader-collect-test-data";
+
+bool ShouldSaveDistilledDataForDebug() {
+#if DCHECK_IS_ON()
+  return base::CommandLine::ForCurrentProcess()->HasSwitch(kCollectSwitch);
+#else
+  return false;
+#endif
+}
+
 void MaybeSaveDistilledDataForDebug(const GURL& url,
                                     const std::string& data,
                                     const std::string& stylesheet,
                                     const std::string& transformed) {
 #if DCHECK_IS_ON()
-  constexpr const char kCollectSwitch[] = "speedreader-collect-test-data";
-  if (!base::CommandLine::ForCurrentProcess()->HasSwitch(kCollectSwitch))
+  if (!ShouldSaveDistilledDataForDebug())
     return;
   const auto dir = base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
       kCollectSwitch);
@@ -49,6 +60,30 @@ void MaybeSaveDistilledDataForDebug(const GURL& url,
 #endif
 }
 
+void WriteToRewriter(Rewriter* rewriter, const std::string& chunk) {
+  rewriter->Write(chunk.data(), chunk.length());
+}
+
+absl::optional<std::string> FinishStreamingDistill(Rewriter* rewriter,
+                                                   const std::string& tail) {
+  // Only covers the work left once the whole body has been received, which is
+  // what the page load waits for.
+  SCOPED_UMA_HISTOGRAM_TIMER("Brave.Speedreader.Distill");
+  // Error occurred
+  if (rewriter->Write(tail.c_str(), tail.length()) != 0) {
+    return absl::nullopt;
+  }
+
+  rewriter->End();
+  const std::string& transformed = rewriter->GetOutput();
+  // TODO(brave-browser/issues/10372): would be better to pass explicit signal
+  // back from rewriter to indicate if content was found
+  if (transformed.length() < 1024) {
+    return absl::nullopt;
+  }
+  return transformed;
+}
+
 }  // namespace
 
 // static
@@ -96,7 +131,22 @@ SpeedReaderURLLoader::SpeedReaderURLLoader(
       delegate_(delegate),
       response_url_(response_url),
       rewriter_service_(rewriter_service),
-      speedreader_service_(speedreader_service) {}
+      speedreader_service_(speedreader_service),
+      rewriter_(nullptr, base::OnTaskRunnerDeleter(nullptr)) {
+  if (rewriter_service_ &&
+      base::FeatureList::IsEnabled(features::kSpeedreaderStreamingDistill)) {
+    distill_task_runner_ = base::ThreadPool::CreateSequencedTaskRunner(
+        {base::TaskPriority::USER_BLOCKING, base::MayBlock()});
+    rewriter_ = std::unique_ptr<Rewriter, base::OnTaskRunnerDeleter>(
+        rewriter_service_
+            ->MakeRewriter(response_url_, speedreader_service_->GetThemeName(),
+                           speedreader_service_->GetFontFamilyName(),
+                           speedreader_service_->GetFontSizeName(),
+                           speedreader_service_->GetContentStyleName())
+            .release(),
+        base::OnTaskRunnerDeleter(distill_task_runner_));
+  }
+}
 
 SpeedReaderURLLoader::~SpeedReaderURLLoader() = default;
 
@@ -107,10 +157,15 @@ void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
     return;
   }
 
-  // TODO(iefremov): We actually can partially |pumpContent| to speedreader,
-  // but skipping it for now to simplify things. Pumping is not free in terms
-  // of CPU ticks, so we will have to keep alive speedreader instance on another
-  // thread.
+  if (rewriter_) {
+    // Parse the page while the rest of it is being received.
+    // |rewriter_| is deleted on |distill_task_runner_|, after this task.
+    distill_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&WriteToRewriter,
+                                  base::Unretained(rewriter_.get()),
+                                  buffered_body_.substr(streamed_bytes_)));
+    streamed_bytes_ = buffered_body_.size();
+  }
 
   body_consumer_watcher_.ArmOrNotify();
 }
@@ -134,6 +189,20 @@ void SpeedReaderURLLoader::CompleteLoading(std::string body) {
   VLOG(2) << __func__ << " buffered body size = " << body.size();
   bytes_remaining_in_buffer_ = body.size();
 
+  if (bytes_remaining_in_buffer_ > 0 && rewriter_) {
+    DCHECK_LE(streamed_bytes_, body.size());
+    std::string tail = body.substr(streamed_bytes_);
+    // Keep the original page in case it can't be distilled.
+    buffered_body_ = std::move(body);
+    distill_task_runner_->PostTaskAndReplyWithResult(
+        FROM_HERE,
+        base::BindOnce(&FinishStreamingDistill,
+                       base::Unretained(rewriter_.get()), std::move(tail)),
+        base::BindOnce(&SpeedReaderURLLoader::OnStreamingDistillComplete,
+                       weak_factory_.GetWeakPtr()));
+    return;
+  }
+
   if (bytes_remaining_in_buffer_ > 0) {
     // Offload heavy distilling to another thread.
     base::ThreadPool::PostTaskAndReplyWithResult(
@@ -181,6 +250,24 @@ void SpeedReaderURLLoader::CompleteLoading(std::string body) {
   BodySnifferURLLoader::CompleteLoading(std::move(body));
 }
 
+void SpeedReaderURLLoader::OnStreamingDistillComplete(
+    absl::optional<std::string> transformed) {
+  DCHECK_EQ(State::kLoading, state_);
+  if (!transformed || !rewriter_service_) {
+    BodySnifferURLLoader::CompleteLoading(std::move(buffered_body_));
+    return;
+  }
+
+  const std::string& stylesheet = rewriter_service_->GetContentStylesheet();
+  if (ShouldSaveDistilledDataForDebug()) {
+    base::ThreadPool::PostTask(
+        FROM_HERE, {base::TaskPriority::BEST_EFFORT, base::MayBlock()},
+        base::BindOnce(&MaybeSaveDistilledDataForDebug, response_url_,
+                       buffered_body_, stylesheet, *transformed));
+  }
+  BodySnifferURLLoader::CompleteLoading(stylesheet + *transformed);
+}
+
 void SpeedReaderURLLoader::OnCompleteSending() {
   // TODO(keur, iefremov): This API could probably be improved with an enum
   // indicating distill success, distill fail, load from cache.
@@ -6,17 +6,20 @@
 #ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 #define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 
+#include <memory>
 #include <string>
 #include <tuple>
 
 #include "base/memory/raw_ptr.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/task/sequenced_task_runner.h"
 #include "base/task/single_thread_task_runner.h"
 #include "brave/components/body_sniffer/body_sniffer_url_loader.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "services/network/public/mojom/url_loader.mojom.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
 
 namespace body_sniffer {
@@ -25,6 +28,7 @@ class BodySnifferThrottle;
 
 namespace speedreader {
 
+class Rewriter;
 class SpeedreaderRewriterService;
 class SpeedreaderService;
 class SpeedReaderThrottle;
@@ -47,6 +51,9 @@ class SpeedreaderThrottleDelegate;
 //            done, this loader will dispatch queued messages like
 //            OnStartLoadingResponseBody() to the destination
 //            loader client, and then the state is changed to kSending.
+//            With streaming distillation, the body is also parsed by the
+//            rewriter on a worker sequence as it arrives, so only extracting
+//            the content is left once it has all been received.
 // kSending: Receives the body and sends it to the destination loader client.
 //           The state changes to kCompleted after all data is sent.
 // kCompleted: All data has been sent to the destination loader.
@@ -85,6 +92,11 @@ class SpeedReaderURLLoader : public body_sniffer::BodySnifferURLLoader {
 
   void CompleteLoading(std::string body) override;
   void OnCompleteSending() override;
+
+  // Called with the distilled page, or absl::nullopt if the page couldn't be
+  // distilled, once streaming distillation is finished.
+  void OnStreamingDistillComplete(absl::optional<std::string> transformed);
+
   base::WeakPtr<SpeedreaderThrottleDelegate> delegate_;
 
   GURL response_url_;
@@ -93,6 +105,14 @@ class SpeedReaderURLLoader : public body_sniffer::BodySnifferURLLoader {
   raw_ptr<SpeedreaderRewriterService> rewriter_service_ = nullptr;
   raw_ptr<SpeedreaderService> speedreader_service_ = nullptr;
 
+  // Only set when streaming distillation is enabled. |rewriter_| is only used
+  // on |distill_task_runner_|.
+  scoped_refptr<base::SequencedTaskRunner> distill_task_runner_;
+  std::unique_ptr<Rewriter, base::OnTaskRunnerDeleter> rewriter_;
+  // The number of bytes of the buffered body which have been passed to
+  // |rewriter_|.
+  size_t streamed_bytes_ = 0;
+
   base::WeakPtrFactory<SpeedReaderURLLoader> weak_factory_{this};
 };
 
@@ -5,13 +5,13 @@
 
 #include "brave/components/url_sanitizer/browser/url_sanitizer_service.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
+#include "base/containers/contains.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
-#include "base/strings/string_split.h"
-#include "base/strings/string_util.h"
 #include "base/task/task_runner_util.h"
 #include "base/task/thread_pool.h"
 #include "base/values.h"
@@ -48,8 +48,7 @@ absl::optional<base::flat_set<std::string>> CreateParamsList(
   return result;
 }
 
-base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> ParseFromJson(
-    const std::string& json) {
+URLSanitizerService::Matchers ParseFromJson(const std::string& json) {
   auto parsed_json = base::JSONReader::ReadAndReturnValueWithError(json);
   if (!parsed_json.has_value()) {
     VLOG(1) << "Error parsing feature JSON: " << parsed_json.error().message;
@@ -59,7 +58,7 @@ base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> ParseFromJson(
   if (!list) {
     return {};
   }
-  base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> matchers;
+  URLSanitizerService::Matchers matchers;
   for (const auto& it : *list) {
     const base::Value::Dict* items = it.GetIfDict();
     if (!items)
@@ -83,12 +82,29 @@ base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> ParseFromJson(
         std::move(include_matcher), std::move(exclude_matcher),
         std::move(*params));
 
-    matchers.insert(std::move(item));
+    matchers.Add(std::move(item));
   }
 
   return matchers;
 }
 
+// Returns true if `kv_string` is a `key=value` pair with a non-empty value
+// whose key is one of `trackers`. Leading and repeated '=' are skipped, as
+// splitting the pair on '=' without empty pieces would.
+bool IsTrackingParameter(base::StringPiece kv_string,
+                         const base::flat_set<std::string>& trackers) {
+  const size_t key_start = kv_string.find_first_not_of('=');
+  if (key_start == base::StringPiece::npos)
+    return false;
+  const size_t key_end = kv_string.find('=', key_start);
+  if (key_end == base::StringPiece::npos ||
+      kv_string.find_first_not_of('=', key_end) == base::StringPiece::npos) {
+    return false;
+  }
+  return base::Contains(trackers,
+                        kv_string.substr(key_start, key_end - key_start));
+}
+
 }  // namespace
 
 URLSanitizerService::URLSanitizerService() = default;
@@ -103,6 +119,59 @@ URLSanitizerService::MatchItem::MatchItem(extensions::URLPatternSet in,
                                           base::flat_set<std::string> prm)
     : include(std::move(in)), exclude(std::move(ex)), params(std::move(prm)) {}
 
+URLSanitizerService::Matchers::Matchers() = default;
+URLSanitizerService::Matchers::Matchers(Matchers&&) = default;
+URLSanitizerService::Matchers& URLSanitizerService::Matchers::operator=(
+    Matchers&&) = default;
+URLSanitizerService::Matchers::~Matchers() = default;
+
+void URLSanitizerService::Matchers::Add(std::unique_ptr<MatchItem> item) {
+  const size_t index = items_.size();
+  bool matches_any_host = false;
+  for (const URLPattern& pattern : item->include) {
+    if (pattern.host().empty()) {
+      matches_any_host = true;
+      continue;
+    }
+    std::vector<HostEntry>& entries = hosts_[pattern.host()];
+    if (!entries.empty() && entries.back().index == index) {
+      entries.back().match_subdomains |= pattern.match_subdomains();
+    } else {
+      entries.push_back({index, pattern.match_subdomains()});
+    }
+  }
+  if (matches_any_host)
+    any_host_.push_back(index);
+  items_.push_back(std::move(item));
+}
+
+std::vector<size_t> URLSanitizerService::Matchers::GetCandidates(
+    base::StringPiece host) const {
+  std::vector<size_t> candidates = any_host_;
+  // URL patterns ignore a trailing dot in the host.
+  if (!host.empty() && host.back() == '.')
+    host.remove_suffix(1);
+  // Look up the host and each of its parent domains, which only match
+  // patterns that include subdomains.
+  for (bool is_host = true; !host.empty(); is_host = false) {
+    auto it = hosts_.find(host);
+    if (it != hosts_.end()) {
+      for (const HostEntry& entry : it->second) {
+        if (is_host || entry.match_subdomains)
+          candidates.push_back(entry.index);
+      }
+    }
+    const size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    host.remove_prefix(dot + 1);
+  }
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+  return candidates;
+}
+
 void URLSanitizerService::Initialize(const std::string& json) {
   base::ThreadPool::PostTaskAndReplyWithResult(
       FROM_HERE, {base::MayBlock()}, base::BindOnce(&ParseFromJson, json),
@@ -110,28 +179,35 @@ void URLSanitizerService::Initialize(const std::string& json) {
                      weak_factory_.GetWeakPtr()));
 }
 
-void URLSanitizerService::UpdateMatchers(
-    base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> mappings) {
-  matchers_ = std::move(mappings);
+void URLSanitizerService::UpdateMatchers(Matchers matchers) {
+  matchers_ = std::move(matchers);
   if (initialization_callback_for_testing_)
     std::move(initialization_callback_for_testing_).Run();
 }
 
 GURL URLSanitizerService::SanitizeURL(const GURL& initial_url) {
-  if (matchers_.empty() || !initial_url.SchemeIsHTTPOrHTTPS())
+  if (matchers_.empty() || !initial_url.SchemeIsHTTPOrHTTPS() ||
+      !initial_url.has_query()) {
     return initial_url;
+  }
   GURL url = initial_url;
-  for (const auto& it : matchers_) {
-    if (!it->include.MatchesURL(url) || it->exclude.MatchesURL(url))
+  for (size_t index : matchers_.GetCandidates(initial_url.host_piece())) {
+    const MatchItem& item = matchers_.item(index);
+    if (!item.include.MatchesURL(url) || item.exclude.MatchesURL(url))
+      continue;
+    auto sanitized_query = StripQueryParameter(url.query_piece(), item.params);
+    // An empty query is dropped even if there was nothing to strip from it.
+    if (!sanitized_query && !url.query_piece().empty())
       continue;
-    auto sanitized_query = StripQueryParameter(url.query(), it->params);
     GURL::Replacements replacements;
-    if (!sanitized_query.empty()) {
-      replacements.SetQueryStr(sanitized_query);
+    if (sanitized_query && !sanitized_query->empty()) {
+      replacements.SetQueryStr(*sanitized_query);
     } else {
       replacements.ClearQuery();
     }
     url = url.ReplaceComponents(replacements);
+    if (!url.has_query())
+      break;
   }
   return url;
 }
@@ -144,35 +220,40 @@ void URLSanitizerService::OnRulesReady(const std::string& json_content) {
 // browser/net/brave_site_hacks_network_delegate_helper.cc::StripQueryParameter()
 // Remove tracking query parameters from a GURL, leaving all
 // other parts untouched.
-std::string URLSanitizerService::StripQueryParameter(
-    const std::string& query,
+// static
+absl::optional<std::string> URLSanitizerService::StripQueryParameter(
+    base::StringPiece query,
     const base::flat_set<std::string>& trackers) {
   // We are using custom query string parsing code here. See
   // https://github.com/brave/brave-core/pull/13726#discussion_r897712350
   // for more information on why this approach was selected.
   //
-  // Split query string by ampersands, remove tracking parameters,
-  // then join the remaining query parameters, untouched, back into
-  // a single query string.
-  const std::vector<std::string> input_kv_strings =
-      SplitString(query, "&", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
-  std::vector<std::string> output_kv_strings;
-  int disallowed_count = 0;
-  for (const std::string& kv_string : input_kv_strings) {
-    const std::vector<std::string> pieces = SplitString(
-        kv_string, "=", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
-    const std::string& key = pieces.empty() ? std::string() : pieces[0];
-    if (pieces.size() >= 2 && trackers.count(key) == 1) {
-      ++disallowed_count;
-    } else {
-      output_kv_strings.push_back(kv_string);
+  // Walk the query string one ampersand-separated parameter at a time. The
+  // output is only built once the first tracking parameter is found, from the
+  // untouched parameters before it and the ones kept after it.
+  absl::optional<std::string> output;
+  bool output_has_parameters = false;
+  size_t kv_start = 0;
+  while (true) {
+    const size_t kv_end = std::min(query.find('&', kv_start), query.size());
+    const base::StringPiece kv_string =
+        query.substr(kv_start, kv_end - kv_start);
+    if (IsTrackingParameter(kv_string, trackers)) {
+      if (!output) {
+        output_has_parameters = kv_start > 0;
+        output.emplace(query.substr(0, kv_start > 0 ? kv_start - 1 : 0));
+      }
+    } else if (output) {
+      if (output_has_parameters)
+        output->push_back('&');
+      output->append(kv_string.data(), kv_string.size());
+      output_has_parameters = true;
     }
+    if (kv_end == query.size())
+      break;
+    kv_start = kv_end + 1;
   }
-  if (disallowed_count > 0) {
-    return base::JoinString(output_kv_strings, "&");
-  } else {
-    return query;
-  }
+  return output;
 }
 
 }  // namespace brave
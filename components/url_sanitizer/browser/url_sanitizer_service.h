@@ -6,9 +6,12 @@
 #ifndef BRAVE_COMPONENTS_URL_SANITIZER_BROWSER_URL_SANITIZER_SERVICE_H_
 #define BRAVE_COMPONENTS_URL_SANITIZER_BROWSER_URL_SANITIZER_SERVICE_H_
 
+#include <stddef.h>
+
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/containers/flat_map.h"
@@ -19,6 +22,7 @@
 #include "brave/components/url_sanitizer/browser/url_sanitizer_component_installer.h"
 #include "components/keyed_service/core/keyed_service.h"
 #include "extensions/common/url_pattern_set.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
 
 namespace brave {
@@ -41,6 +45,35 @@ class URLSanitizerService : public KeyedService,
     base::flat_set<std::string> params;
   };
 
+  // The match items of the rules, in rule order, indexed by the hosts of
+  // their include patterns.
+  class Matchers {
+   public:
+    Matchers();
+    Matchers(Matchers&&);
+    Matchers& operator=(Matchers&&);
+    ~Matchers();
+
+    void Add(std::unique_ptr<MatchItem> item);
+    // Returns the indices, in rule order, of the items whose include patterns
+    // may match a URL on `host`.
+    std::vector<size_t> GetCandidates(base::StringPiece host) const;
+
+    bool empty() const { return items_.empty(); }
+    const MatchItem& item(size_t index) const { return *items_[index]; }
+
+   private:
+    struct HostEntry {
+      size_t index;
+      bool match_subdomains;
+    };
+
+    std::vector<std::unique_ptr<MatchItem>> items_;
+    base::flat_map<std::string, std::vector<HostEntry>> hosts_;
+    // Items with an include pattern which matches any host.
+    std::vector<size_t> any_host_;
+  };
+
   GURL SanitizeURL(const GURL& url);
 
   void SetInitializationCallbackForTesting(base::OnceClosure callback) {
@@ -52,14 +85,17 @@ class URLSanitizerService : public KeyedService,
  protected:
   friend class URLSanitizerServiceUnitTest;
 
-  void UpdateMatchers(
-      base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>>);
+  void UpdateMatchers(Matchers matchers);
+  const Matchers& matchers_for_testing() const { return matchers_; }
 
-  std::string StripQueryParameter(const std::string& query,
-                                  const base::flat_set<std::string>& trackers);
+  // Returns `query` without the `trackers` parameters, or `absl::nullopt` if it
+  // has none of them.
+  static absl::optional<std::string> StripQueryParameter(
+      base::StringPiece query,
+      const base::flat_set<std::string>& trackers);
 
  private:
-  base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> matchers_;
+  Matchers matchers_;
   base::OnceClosure initialization_callback_for_testing_;
   base::WeakPtrFactory<URLSanitizerService> weak_factory_{this};
 };
@@ -9,8 +9,12 @@
 
 #include "base/containers/flat_set.h"
 #include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
 #include "base/test/task_environment.h"
+#include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
 #include "url/gurl.h"
 
 namespace brave {
@@ -84,8 +88,33 @@ TEST_F(URLSanitizerServiceUnitTest, StripQueryParameter) {
           "fbclid=11&fbclid=11&fbclid=22&param1=1&second=2&second=2&second=2",
           list),
       "param1=1");
-  EXPECT_EQ(StripQueryParameter("param1=1", list), "param1=1");
-  EXPECT_EQ(StripQueryParameter("", list), "");
+  EXPECT_EQ(StripQueryParameter("=fbclid=11&fbclid==22&a=1", list), "a=1");
+  // Parameters without a value are kept.
+  EXPECT_EQ(StripQueryParameter("fbclid&second=&a=1&second=2", list),
+            "fbclid&second=&a=1");
+  EXPECT_EQ(StripQueryParameter("a=1&&fbclid=11&", list), "a=1&&");
+  EXPECT_EQ(StripQueryParameter("param1=1", list), absl::nullopt);
+  EXPECT_EQ(StripQueryParameter("", list), absl::nullopt);
+}
+
+TEST_F(URLSanitizerServiceUnitTest, IndexesMatchersByHost) {
+  WaitInitialization(kTestPatterns);
+
+  // Only the rule for any host applies outside of the indexed hosts.
+  EXPECT_EQ(std::vector<size_t>({1}),
+            matchers_for_testing().GetCandidates("brave.com"));
+  EXPECT_EQ(std::vector<size_t>({0, 1}),
+            matchers_for_testing().GetCandidates("twitter.com"));
+  EXPECT_EQ(std::vector<size_t>({0, 1}),
+            matchers_for_testing().GetCandidates("mobile.twitter.com."));
+  EXPECT_EQ(std::vector<size_t>({1}),
+            matchers_for_testing().GetCandidates("twitter.com.evil.com"));
+  // Patterns without a subdomain wildcard only match their exact host.
+  EXPECT_EQ(std::vector<size_t>({1, 2}),
+            matchers_for_testing().GetCandidates(
+                "dev-pages.bravesoftware.com"));
+  EXPECT_EQ(std::vector<size_t>({1}), matchers_for_testing().GetCandidates(
+                                          "sub.dev-pages.bravesoftware.com"));
 }
 
 TEST_F(URLSanitizerServiceUnitTest, ClearURLS) {
@@ -154,4 +183,64 @@ TEST_F(URLSanitizerServiceUnitTest, ClearURLS) {
             GURL("ws://localhost:8080/?utm_source=web"));
 }
 
+TEST_F(URLSanitizerServiceUnitTest, BenchmarkSanitizeURL) {
+  // Shaped like the shipped clean-urls.json: one rule for the common tracking
+  // parameters on any host, and site specific rules.
+  constexpr size_t kSiteRuleCount = 200;
+  constexpr size_t kIterations = 20000;
+
+  std::string json = R"([{ "include": [ "*://*/*" ], "params": [
+      "utm_source", "utm_medium", "utm_campaign", "utm_term", "utm_content",
+      "fbclid", "gclid", "mc_eid", "_hsenc" ] })";
+  for (size_t i = 0; i < kSiteRuleCount; i++) {
+    json += base::StringPrintf(
+        R"(, { "include": [ "*://*.site%zu.com/*" ],
+               "exclude": [ "*://*.site%zu.com/account/*" ],
+               "params": [ "ref", "si" ] })",
+        i, i);
+  }
+  json += "]";
+  WaitInitialization(json);
+
+  std::vector<GURL> urls;
+  for (size_t i = 0; i < kIterations; i++) {
+    switch (i % 4) {
+      case 0:
+        urls.emplace_back(base::StringPrintf(
+            "https://www.site%zu.com/watch?v=abc&si=tracker", i % 400));
+        break;
+      case 1:
+        urls.emplace_back(base::StringPrintf(
+            "https://news%zu.example/article?id=%zu&utm_source=feed&"
+            "utm_medium=rss",
+            i % 100, i));
+        break;
+      case 2:
+        urls.emplace_back(
+            base::StringPrintf("https://shop%zu.example/?q=brave&page=2", i));
+        break;
+      default:
+        urls.emplace_back(
+            base::StringPrintf("https://blog%zu.example/post/%zu", i % 50, i));
+        break;
+    }
+  }
+
+  size_t sanitized_count = 0;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (const GURL& url : urls) {
+    if (SanitizeURL(url) != url)
+      sanitized_count++;
+  }
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  // Half of the site URLs are on hosts with a rule, and all of the news URLs
+  // carry utm parameters.
+  EXPECT_EQ(kIterations / 8 + kIterations / 4, sanitized_count);
+
+  perf_test::PerfResultReporter reporter(
+      "URLSanitizer", base::NumberToString(kSiteRuleCount + 1) + "_rules");
+  reporter.RegisterImportantMetric(".sanitize_url", "us");
+  reporter.AddResult(".sanitize_url", elapsed.InMicrosecondsF() / kIterations);
+}
+
 }  // namespace brave
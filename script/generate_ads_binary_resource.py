@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 The Brave Authors. All rights reserved.
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this file,
+# You can obtain one at https://mozilla.org/MPL/2.0/.
+
+"""
+Converts a JSON ads text classification or text embedding resource to the
+binary resource format read by
+//brave/vendor/bat-native-ads/src/bat/ads/internal/resources/binary_resource_reader.h
+
+Usage:
+    generate_ads_binary_resource.py --type text_classification \
+        --input resource.json --output resource.bin
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b'BATR'
+FORMAT_VERSION = 1
+
+RESOURCE_TYPES = {
+    'text_classification': 1,
+    'text_embedding': 2,
+}
+
+TRANSFORMATION_TYPES = {
+    'TO_LOWER': 1,
+    'NORMALIZE': 2,
+    'HASHED_NGRAMS': 3,
+}
+
+
+def pack_uint32(value):
+    return struct.pack('<I', value)
+
+
+def pack_string(value):
+    encoded = value.encode('utf-8')
+    return pack_uint32(len(encoded)) + encoded
+
+
+def pack_floats(values):
+    return struct.pack('<%df' % len(values), *values)
+
+
+def convert_text_classification(resource):
+    out = [
+        pack_uint32(resource['version']),
+        pack_string(resource['timestamp']),
+        pack_string(resource['locale']),
+    ]
+
+    transformations = resource['transformations']
+    out.append(pack_uint32(len(transformations)))
+    for transformation in transformations:
+        transformation_type = transformation['transformation_type']
+        out.append(pack_uint32(TRANSFORMATION_TYPES[transformation_type]))
+        if transformation_type == 'HASHED_NGRAMS':
+            params = transformation['params']
+            ngrams_range = params['ngrams_range']
+            out.append(pack_uint32(params['num_buckets']))
+            out.append(pack_uint32(len(ngrams_range)))
+            out.extend(pack_uint32(n) for n in ngrams_range)
+
+    classifier = resource['classifier']
+    if classifier['classifier_type'] != 'LINEAR':
+        raise ValueError('Unsupported classifier type')
+
+    classes = classifier['classes']
+    class_weights = classifier['class_weights']
+    biases = classifier['biases']
+    if len(biases) != len(classes):
+        raise ValueError('Mismatched class and bias count')
+
+    dimension_count = len(class_weights[classes[0]])
+    out.append(pack_uint32(len(classes)))
+    out.append(pack_uint32(dimension_count))
+    out.extend(pack_string(class_name) for class_name in classes)
+    out.extend(struct.pack('<d', bias) for bias in biases)
+    for class_name in classes:
+        weights = class_weights[class_name]
+        if len(weights) != dimension_count:
+            raise ValueError('Mismatched weight count for ' + class_name)
+        out.append(pack_floats(weights))
+
+    return b''.join(out)
+
+
+def convert_text_embedding(resource):
+    embeddings = {
+        token: embedding
+        for token, embedding in resource['embeddings'].items()
+        if isinstance(embedding, list)
+    }
+    if not embeddings:
+        raise ValueError('Missing embeddings')
+
+    dimension = len(next(iter(embeddings.values())))
+
+    out = [
+        pack_uint32(resource['version']),
+        pack_string(resource.get('timestamp', '')),
+        pack_string(resource['locale']),
+        pack_uint32(dimension),
+        pack_uint32(len(embeddings)),
+    ]
+
+    # Tokens are sorted by their UTF-8 bytes to match std::map ordering.
+    for token in sorted(embeddings, key=lambda token: token.encode('utf-8')):
+        embedding = embeddings[token]
+        if len(embedding) != dimension:
+            raise ValueError('Mismatched embedding dimension for ' + token)
+        out.append(pack_string(token))
+        out.append(pack_floats(embedding))
+
+    return b''.join(out)
+
+
+def main(args):
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--type',
+                        required=True,
+                        choices=sorted(RESOURCE_TYPES.keys()),
+                        help='Resource type.')
+    parser.add_argument('--input',
+                        required=True,
+                        help='Path to the JSON resource.')
+    parser.add_argument('--output',
+                        required=True,
+                        help='Path to write the binary resource.')
+    options = parser.parse_args(args)
+
+    with open(options.input, 'r', encoding='utf-8') as f:
+        resource = json.load(f)
+
+    if options.type == 'text_classification':
+        body = convert_text_classification(resource)
+    else:
+        body = convert_text_embedding(resource)
+
+    with open(options.output, 'wb') as f:
+        f.write(MAGIC)
+        f.write(pack_uint32(FORMAT_VERSION))
+        f.write(pack_uint32(RESOURCE_TYPES[options.type]))
+        f.write(body)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,230 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/third_party/blink/renderer/brave_farbling_hash.h"
+
+#include <string.h>
+
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace brave {
+
+namespace {
+
+// The accumulator layout and constants follow XXH3: each 64-byte stripe is
+// mixed into eight 64-bit lanes with a 32x32->64 multiply, which maps onto
+// SSE2 and NEON, and the lanes are scrambled once per block.
+constexpr size_t kLanes = 8;
+constexpr size_t kStripeSize = kLanes * sizeof(uint64_t);
+constexpr size_t kStripesPerBlock = 16;
+
+constexpr uint32_t kPrime32_1 = 0x9E3779B1U;
+constexpr uint32_t kPrime32_2 = 0x85EBCA77U;
+constexpr uint32_t kPrime32_3 = 0xC2B2AE3DU;
+constexpr uint64_t kPrime64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime64_5 = 0x27D4EB2F165667C5ULL;
+
+// Tell apart the lanes which share a word of the key.
+constexpr uint64_t kLaneSalts[kLanes] = {
+    0, 0, 0, 0, kPrime64_1, kPrime64_2, kPrime64_3, kPrime64_4};
+
+struct State {
+  alignas(16) uint64_t acc[kLanes] = {kPrime32_3, kPrime64_1, kPrime64_2,
+                                      kPrime64_3, kPrime64_4, kPrime32_2,
+                                      kPrime64_5, kPrime32_1};
+  alignas(16) uint64_t secret[kLanes];
+};
+
+inline uint64_t Load64(const uint8_t* p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof v);
+  return v;
+}
+
+inline uint64_t Rotl64(uint64_t v, int bits) {
+  return (v << bits) | (v >> (64 - bits));
+}
+
+inline uint64_t Avalanche(uint64_t h) {
+  h ^= h >> 33;
+  h *= kPrime64_2;
+  h ^= h >> 29;
+  h *= kPrime64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+void AccumulateScalar(State* state, const uint8_t* stripes, size_t count) {
+  for (size_t s = 0; s < count; s++, stripes += kStripeSize) {
+    for (size_t i = 0; i < kLanes; i++) {
+      const uint64_t data = Load64(stripes + i * sizeof(uint64_t));
+      const uint64_t keyed = data ^ state->secret[i];
+      state->acc[i ^ 1] += data;
+      state->acc[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+    }
+  }
+}
+
+void ScrambleScalar(State* state) {
+  for (size_t i = 0; i < kLanes; i++) {
+    uint64_t acc = state->acc[i];
+    acc ^= acc >> 47;
+    acc ^= state->secret[i];
+    state->acc[i] = acc * kPrime32_1;
+  }
+}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+void AccumulateSimd(State* state, const uint8_t* stripes, size_t count) {
+  __m128i acc[kLanes / 2];
+  __m128i secret[kLanes / 2];
+  for (size_t i = 0; i < kLanes / 2; i++) {
+    acc[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(state->acc) + i);
+    secret[i] =
+        _mm_load_si128(reinterpret_cast<const __m128i*>(state->secret) + i);
+  }
+  for (size_t s = 0; s < count; s++, stripes += kStripeSize) {
+    for (size_t i = 0; i < kLanes / 2; i++) {
+      const __m128i data =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripes) + i);
+      const __m128i keyed = _mm_xor_si128(data, secret[i]);
+      const __m128i keyed_hi =
+          _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1));
+      const __m128i product = _mm_mul_epu32(keyed, keyed_hi);
+      const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      acc[i] = _mm_add_epi64(acc[i], _mm_add_epi64(product, swapped));
+    }
+  }
+  for (size_t i = 0; i < kLanes / 2; i++) {
+    _mm_store_si128(reinterpret_cast<__m128i*>(state->acc) + i, acc[i]);
+  }
+}
+
+void ScrambleSimd(State* state) {
+  const __m128i prime = _mm_set1_epi32(static_cast<int>(kPrime32_1));
+  for (size_t i = 0; i < kLanes / 2; i++) {
+    __m128i* acc_ptr = reinterpret_cast<__m128i*>(state->acc) + i;
+    __m128i acc = _mm_load_si128(acc_ptr);
+    acc = _mm_xor_si128(acc, _mm_srli_epi64(acc, 47));
+    acc = _mm_xor_si128(
+        acc,
+        _mm_load_si128(reinterpret_cast<const __m128i*>(state->secret) + i));
+    // There is no 64-bit multiply in SSE2, so combine the products of both
+    // halves of each lane.
+    const __m128i product_lo = _mm_mul_epu32(acc, prime);
+    const __m128i product_hi =
+        _mm_mul_epu32(_mm_shuffle_epi32(acc, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+    _mm_store_si128(acc_ptr, _mm_add_epi64(product_lo,
+                                           _mm_slli_epi64(product_hi, 32)));
+  }
+}
+
+#elif defined(ARCH_CPU_ARM64)
+
+void AccumulateSimd(State* state, const uint8_t* stripes, size_t count) {
+  uint64x2_t acc[kLanes / 2];
+  uint64x2_t secret[kLanes / 2];
+  for (size_t i = 0; i < kLanes / 2; i++) {
+    acc[i] = vld1q_u64(state->acc + 2 * i);
+    secret[i] = vld1q_u64(state->secret + 2 * i);
+  }
+  for (size_t s = 0; s < count; s++, stripes += kStripeSize) {
+    for (size_t i = 0; i < kLanes / 2; i++) {
+      const uint64x2_t data =
+          vreinterpretq_u64_u8(vld1q_u8(stripes + 16 * i));
+      const uint64x2_t keyed = veorq_u64(data, secret[i]);
+      const uint64x2_t product =
+          vmull_u32(vmovn_u64(keyed), vshrn_n_u64(keyed, 32));
+      const uint64x2_t swapped = vextq_u64(data, data, 1);
+      acc[i] = vaddq_u64(acc[i], vaddq_u64(product, swapped));
+    }
+  }
+  for (size_t i = 0; i < kLanes / 2; i++) {
+    vst1q_u64(state->acc + 2 * i, acc[i]);
+  }
+}
+
+void ScrambleSimd(State* state) {
+  for (size_t i = 0; i < kLanes / 2; i++) {
+    uint64x2_t acc = vld1q_u64(state->acc + 2 * i);
+    acc = veorq_u64(acc, vshrq_n_u64(acc, 47));
+    acc = veorq_u64(acc, vld1q_u64(state->secret + 2 * i));
+    const uint64x2_t product_hi =
+        vshlq_n_u64(vmull_n_u32(vshrn_n_u64(acc, 32), kPrime32_1), 32);
+    vst1q_u64(state->acc + 2 * i,
+              vmlal_n_u32(product_hi, vmovn_u64(acc), kPrime32_1));
+  }
+}
+
+#endif
+
+template <void (*Accumulate)(State*, const uint8_t*, size_t),
+          void (*Scramble)(State*)>
+void Hash(const uint8_t key[kFarblingHashSize],
+          const uint8_t* data,
+          size_t size,
+          uint8_t digest[kFarblingHashSize]) {
+  State state;
+  for (size_t i = 0; i < kLanes; i++) {
+    state.secret[i] = Load64(key + (i % 4) * sizeof(uint64_t)) ^ kLaneSalts[i];
+  }
+
+  constexpr size_t kBlockSize = kStripeSize * kStripesPerBlock;
+  const size_t block_count = size / kBlockSize;
+  for (size_t b = 0; b < block_count; b++) {
+    Accumulate(&state, data + b * kBlockSize, kStripesPerBlock);
+    Scramble(&state);
+  }
+  const uint8_t* rest = data + block_count * kBlockSize;
+  const size_t rest_size = size - block_count * kBlockSize;
+  Accumulate(&state, rest, rest_size / kStripeSize);
+  if (rest_size % kStripeSize) {
+    // The length is mixed in below, so zero padding is unambiguous.
+    uint8_t last_stripe[kStripeSize] = {};
+    memcpy(last_stripe, rest + rest_size / kStripeSize * kStripeSize,
+           rest_size % kStripeSize);
+    Accumulate(&state, last_stripe, 1);
+  }
+
+  const uint64_t length = static_cast<uint64_t>(size) * kPrime64_1;
+  for (size_t i = 0; i < kFarblingHashSize / sizeof(uint64_t); i++) {
+    uint64_t h = state.acc[2 * i] ^ state.secret[2 * i + 1];
+    h += Rotl64(state.acc[2 * i + 1] ^ state.secret[2 * i], 31) * kPrime64_2;
+    h = Avalanche(h ^ length ^ (i + 1));
+    memcpy(digest + i * sizeof(uint64_t), &h, sizeof h);
+  }
+}
+
+}  // namespace
+
+void FarblingHash(const uint8_t key[kFarblingHashSize],
+                  const uint8_t* data,
+                  size_t size,
+                  uint8_t digest[kFarblingHashSize]) {
+#if defined(ARCH_CPU_X86_FAMILY) || defined(ARCH_CPU_ARM64)
+  Hash<AccumulateSimd, ScrambleSimd>(key, data, size, digest);
+#else
+  Hash<AccumulateScalar, ScrambleScalar>(key, data, size, digest);
+#endif
+}
+
+void FarblingHashScalarForTesting(const uint8_t key[kFarblingHashSize],
+                                  const uint8_t* data,
+                                  size_t size,
+                                  uint8_t digest[kFarblingHashSize]) {
+  Hash<AccumulateScalar, ScrambleScalar>(key, data, size, digest);
+}
+
+}  // namespace brave
@@ -0,0 +1,42 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_BRAVE_FARBLING_HASH_H_
+#define BRAVE_THIRD_PARTY_BLINK_RENDERER_BRAVE_FARBLING_HASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "third_party/blink/public/platform/web_common.h"
+
+namespace brave {
+
+// Size of the keys and digests of FarblingHash().
+constexpr size_t kFarblingHashSize = 32;
+
+// Digests |size| bytes at |data| with a fast keyed hash, for farbling large
+// buffers such as canvas pixels where hashing them with HMAC-SHA256 dominates
+// the cost. The bulk of the input is processed eight 64-bit lanes at a time,
+// with SSE2 or NEON where available; all paths produce the same digest.
+//
+// This is not a cryptographic hash: callers which expose anything derived
+// from the digest should pass it through a cryptographic MAC, and |key|
+// should itself be derived through one.
+BLINK_EXPORT void FarblingHash(const uint8_t key[kFarblingHashSize],
+                               const uint8_t* data,
+                               size_t size,
+                               uint8_t digest[kFarblingHashSize]);
+
+// The portable implementation of FarblingHash(), for testing that the
+// vectorized one matches it.
+BLINK_EXPORT void FarblingHashScalarForTesting(
+    const uint8_t key[kFarblingHashSize],
+    const uint8_t* data,
+    size_t size,
+    uint8_t digest[kFarblingHashSize]);
+
+}  // namespace brave
+
+#endif  // BRAVE_THIRD_PARTY_BLINK_RENDERER_BRAVE_FARBLING_HASH_H_
@@ -0,0 +1,99 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/third_party/blink/renderer/brave_farbling_hash.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "base/rand_util.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "crypto/hmac.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace brave {
+
+namespace {
+
+constexpr uint8_t kKey[kFarblingHashSize] = {
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x10, 0x32, 0x54,
+    0x76, 0x98, 0xba, 0xdc, 0xfe, 0x0f, 0x1e, 0x2d, 0x3c, 0x4b, 0x5a,
+    0x69, 0x78, 0x87, 0x96, 0xa5, 0xb4, 0xc3, 0xd2, 0xe1, 0xf0};
+
+std::vector<uint8_t> HashOf(const std::vector<uint8_t>& data,
+                            const uint8_t* key = kKey) {
+  std::vector<uint8_t> digest(kFarblingHashSize);
+  FarblingHash(key, data.data(), data.size(), digest.data());
+  return digest;
+}
+
+}  // namespace
+
+TEST(BraveFarblingHashTest, MatchesScalarImplementation) {
+  // Cover partial stripes and blocks, and inputs spanning several blocks.
+  for (size_t size : {0, 1, 63, 64, 65, 1023, 1024, 1025, 4096 * 4 + 17}) {
+    std::vector<uint8_t> data = base::RandBytesAsVector(size);
+    std::vector<uint8_t> scalar_digest(kFarblingHashSize);
+    FarblingHashScalarForTesting(kKey, data.data(), data.size(),
+                                 scalar_digest.data());
+    EXPECT_EQ(scalar_digest, HashOf(data)) << "size " << size;
+  }
+}
+
+TEST(BraveFarblingHashTest, DependsOnKeyContentsAndLength) {
+  std::vector<uint8_t> data(256 * 256 * 4);
+  const std::vector<uint8_t> digest = HashOf(data);
+  EXPECT_EQ(digest, HashOf(data));
+
+  uint8_t other_key[kFarblingHashSize];
+  memcpy(other_key, kKey, sizeof other_key);
+  other_key[31] ^= 1;
+  EXPECT_NE(digest, HashOf(data, other_key));
+
+  data[data.size() / 2] ^= 1;
+  EXPECT_NE(digest, HashOf(data));
+  data[data.size() / 2] ^= 1;
+
+  // Zero padding of the last stripe doesn't collide with actual zeros.
+  data.push_back(0);
+  EXPECT_NE(digest, HashOf(data));
+}
+
+// Compares digesting canvases of growing sizes with HMAC-SHA256, as canvas
+// farbling does without the fast hash, and with FarblingHash().
+TEST(BraveFarblingHashTest, BenchmarkAgainstHmac) {
+  for (size_t side = 256; side <= 4096; side *= 2) {
+    const std::vector<uint8_t> pixels =
+        base::RandBytesAsVector(side * side * 4);
+    perf_test::PerfResultReporter reporter(
+        "CanvasFarbling", base::StringPrintf("%zux%zu", side, side));
+    reporter.RegisterImportantMetric(".hmac_sha256", "ms");
+    reporter.RegisterImportantMetric(".farbling_hash", "ms");
+
+    crypto::HMAC hmac(crypto::HMAC::SHA256);
+    ASSERT_TRUE(hmac.Init(kKey, sizeof kKey));
+    uint8_t hmac_digest[32];
+    base::TimeTicks start = base::TimeTicks::Now();
+    ASSERT_TRUE(hmac.Sign(
+        base::StringPiece(reinterpret_cast<const char*>(pixels.data()),
+                          pixels.size()),
+        hmac_digest, sizeof hmac_digest));
+    reporter.AddResult(".hmac_sha256", base::TimeTicks::Now() - start);
+
+    uint8_t digest[kFarblingHashSize];
+    start = base::TimeTicks::Now();
+    FarblingHash(kKey, pixels.data(), pixels.size(), digest);
+    ASSERT_TRUE(hmac.Sign(
+        base::StringPiece(reinterpret_cast<const char*>(digest), sizeof digest),
+        hmac_digest, sizeof hmac_digest));
+    reporter.AddResult(".farbling_hash", base::TimeTicks::Now() - start);
+  }
+}
+
+}  // namespace brave
@@ -28,11 +28,10 @@ ItemDesc EdgeBindingEvent::GetItemDesc() const {
   return GetItemName();
 }
 
-void EdgeBindingEvent::AddGraphMLAttributes(xmlDocPtr doc,
-                                            xmlNodePtr parent_node) const {
-  GraphEdge::AddGraphMLAttributes(doc, parent_node);
+void EdgeBindingEvent::AddGraphMLAttributes(GraphMLWriter* writer) const {
+  GraphEdge::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefScriptPosition)
-      ->AddValueNode(doc, parent_node, script_position_);
+      ->AddValueNode(writer, script_position_);
 }
 
 bool EdgeBindingEvent::IsEdgeBindingEvent() const {
@@ -30,8 +30,7 @@ class EdgeExecuteAttr : public EdgeExecute {
   ItemName GetItemName() const override;
   ItemDesc GetItemDesc() const override;
 
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLAttributes(GraphMLWriter* writer) const override;
 
   bool IsEdgeExecuteAttr() const override;
 
@@ -36,8 +36,7 @@ class EdgeJSCall final : public EdgeJS {
   ItemName GetItemName() const override;
   ItemDesc GetItemDesc() const override;
 
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLAttributes(GraphMLWriter* writer) const override;
 
   bool IsEdgeJSCall() const override;
 
@@ -30,11 +30,9 @@ ItemName EdgeStorage::GetItemDesc() const {
   return builder.str();
 }
 
-void EdgeStorage::AddGraphMLAttributes(xmlDocPtr doc,
-                                       xmlNodePtr parent_node) const {
-  GraphEdge::AddGraphMLAttributes(doc, parent_node);
-  GraphMLAttrDefForType(kGraphMLAttrDefKey)
-      ->AddValueNode(doc, parent_node, key_);
+void EdgeStorage::AddGraphMLAttributes(GraphMLWriter* writer) const {
+  GraphEdge::AddGraphMLAttributes(writer);
+  GraphMLAttrDefForType(kGraphMLAttrDefKey)->AddValueNode(writer, key_);
 }
 
 bool EdgeStorage::IsEdgeStorage() const {
@@ -6,8 +6,6 @@
 #ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPH_ITEM_GRAPH_ITEM_H_
 #define BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPH_ITEM_GRAPH_ITEM_H_
 
-#include <libxml/tree.h>
-
 #include "base/memory/raw_ptr.h"
 #include "base/time/time.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/types.h"
@@ -15,6 +13,7 @@
 namespace brave_page_graph {
 
 class GraphItemContext;
+class GraphMLWriter;
 
 class GraphItem {
  public:
@@ -28,9 +27,8 @@ class GraphItem {
   virtual ItemDesc GetItemDesc() const;
 
   virtual GraphMLId GetGraphMLId() const = 0;
-  virtual void AddGraphMLTag(xmlDocPtr doc, xmlNodePtr parent_node) const = 0;
-  virtual void AddGraphMLAttributes(xmlDocPtr doc,
-                                    xmlNodePtr parent_node) const;
+  virtual void AddGraphMLTag(GraphMLWriter* writer) const = 0;
+  virtual void AddGraphMLAttributes(GraphMLWriter* writer) const;
 
   virtual bool IsEdge() const;
   virtual bool IsNode() const;
@@ -25,17 +25,16 @@ ItemDesc NodeFingerprintingFilter::GetItemDesc() const {
 }
 
 void NodeFingerprintingFilter::AddGraphMLAttributes(
-    xmlDocPtr doc,
-    xmlNodePtr parent_node) const {
-  NodeFilter::AddGraphMLAttributes(doc, parent_node);
+    GraphMLWriter* writer) const {
+  NodeFilter::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefPrimaryPattern)
-      ->AddValueNode(doc, parent_node, rule_.primary_pattern);
+      ->AddValueNode(writer, rule_.primary_pattern);
   GraphMLAttrDefForType(kGraphMLAttrDefSecondaryPattern)
-      ->AddValueNode(doc, parent_node, rule_.secondary_pattern);
+      ->AddValueNode(writer, rule_.secondary_pattern);
   GraphMLAttrDefForType(kGraphMLAttrDefSource)
-      ->AddValueNode(doc, parent_node, rule_.source);
+      ->AddValueNode(writer, rule_.source);
   GraphMLAttrDefForType(kGraphMLAttrDefIncognito)
-      ->AddValueNode(doc, parent_node, rule_.incognito);
+      ->AddValueNode(writer, rule_.incognito);
 }
 
 bool NodeFingerprintingFilter::IsNodeFingerprintingFilter() const {
@@ -25,8 +25,7 @@ class NodeDOMRoot final : public NodeHTMLElement {
   ItemName GetItemName() const override;
   ItemDesc GetItemDesc() const override;
 
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLAttributes(GraphMLWriter* writer) const override;
 
   bool IsNodeDOMRoot() const override;
 
@@ -34,9 +34,8 @@ class NodeHTMLElement : public NodeHTML {
   ItemName GetItemName() const override;
   ItemDesc GetItemDesc() const override;
 
-  void AddGraphMLTag(xmlDocPtr doc, xmlNodePtr parent_node) const override;
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLTag(GraphMLWriter* writer) const override;
+  void AddGraphMLAttributes(GraphMLWriter* writer) const override;
 
   bool IsNodeHTMLElement() const override;
 
@@ -27,11 +27,10 @@ ItemDesc NodeRemoteFrame::GetItemDesc() const {
   return builder.str();
 }
 
-void NodeRemoteFrame::AddGraphMLAttributes(xmlDocPtr doc,
-                                           xmlNodePtr parent_node) const {
-  GraphNode::AddGraphMLAttributes(doc, parent_node);
+void NodeRemoteFrame::AddGraphMLAttributes(GraphMLWriter* writer) const {
+  GraphNode::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefFrameId)
-      ->AddValueNode(doc, parent_node, frame_id_);
+      ->AddValueNode(writer, frame_id_);
 }
 
 bool NodeRemoteFrame::IsNodeRemoteFrame() const {
@@ -6,12 +6,12 @@
 #ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPHML_H_
 #define BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPHML_H_
 
-#include <libxml/tree.h>
 #include <string>
 #include <vector>
 
 #include "base/containers/flat_map.h"
 #include "base/time/time.h"
+#include "brave/components/brave_page_graph/common/graphml_writer.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/types.h"
 
 namespace brave_page_graph {
@@ -23,31 +23,15 @@ class GraphMLAttr {
               const GraphMLAttrType type = kGraphMLAttrTypeString);
 
   GraphMLId GetGraphMLId() const;
-  void AddDefinitionNode(xmlNodePtr parent_node) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const char* value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const std::string& value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const int value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const bool value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const int64_t value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const uint64_t value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const double value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const base::TimeDelta value) const;
+  void AddDefinitionNode(GraphMLWriter* writer) const;
+  void AddValueNode(GraphMLWriter* writer, const char* value) const;
+  void AddValueNode(GraphMLWriter* writer, const std::string& value) const;
+  void AddValueNode(GraphMLWriter* writer, const int value) const;
+  void AddValueNode(GraphMLWriter* writer, const bool value) const;
+  void AddValueNode(GraphMLWriter* writer, const int64_t value) const;
+  void AddValueNode(GraphMLWriter* writer, const uint64_t value) const;
+  void AddValueNode(GraphMLWriter* writer, const double value) const;
+  void AddValueNode(GraphMLWriter* writer, const base::TimeDelta value) const;
 
  protected:
   const uint64_t id_;
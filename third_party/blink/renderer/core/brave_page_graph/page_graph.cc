@@ -5,8 +5,6 @@
 
 #include "brave/third_party/blink/renderer/core/brave_page_graph/page_graph.h"
 
-#include <libxml/tree.h>
-
 #include <signal.h>
 #include <climits>
 #include <iostream>
@@ -123,6 +121,7 @@
 #include "third_party/blink/renderer/platform/weborigin/kurl.h"
 #include "third_party/blink/renderer/platform/wtf/casting.h"
 #include "third_party/blink/renderer/platform/wtf/text/base64.h"
+#include "third_party/blink/renderer/platform/wtf/text/string_builder.h"
 #include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
 #include "url/gurl.h"
 #include "v8/include/v8.h"
@@ -186,6 +185,8 @@ namespace {
 constexpr char kPageGraphVersion[] = "0.3.0";
 constexpr char kPageGraphUrl[] =
     "https://github.com/brave/brave-browser/wiki/PageGraph";
+// The graph is exported in chunks of about this many bytes.
+constexpr size_t kGraphMLChunkSize = 64 * 1024;
 
 PageGraph* GetPageGraphFromIsolate(v8::Isolate* isolate) {
   blink::LocalDOMWindow* window = blink::CurrentDOMWindow(isolate);
@@ -956,68 +957,100 @@ void PageGraph::GenerateReportForNode(const blink::DOMNodeId node_id,
 }
 
 String PageGraph::ToGraphML() const {
-  xmlDocPtr graphml_doc = xmlNewDoc(BAD_CAST "1.0");
-  xmlNodePtr graphml_root_node = xmlNewNode(nullptr, BAD_CAST "graphml");
-  xmlDocSetRootElement(graphml_doc, graphml_root_node);
-
-  xmlNewNs(graphml_root_node, BAD_CAST "http://graphml.graphdrawing.org/xmlns",
-           nullptr);
-  xmlNsPtr xsi_ns = xmlNewNs(
-      graphml_root_node, BAD_CAST "http://www.w3.org/2001/XMLSchema-instance",
-      BAD_CAST "xsi");
-  xmlNewNsProp(graphml_root_node, xsi_ns, BAD_CAST "schemaLocation",
-               BAD_CAST
-               "http://graphml.graphdrawing.org/xmlns "
-               "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd");
-
-  xmlNodePtr desc_container_node =
-      xmlNewChild(graphml_root_node, nullptr, BAD_CAST "desc", nullptr);
-  xmlNewTextChild(desc_container_node, nullptr, BAD_CAST "version",
-                  BAD_CAST kPageGraphVersion);
-  xmlNewTextChild(desc_container_node, nullptr, BAD_CAST "about",
-                  BAD_CAST kPageGraphUrl);
-  xmlNewTextChild(desc_container_node, nullptr, BAD_CAST "is_root",
-                  BAD_CAST(IsRootFrame() ? "true" : "false"));
-  xmlNewTextChild(desc_container_node, nullptr, BAD_CAST "frame_id",
-                  BAD_CAST frame_id_.c_str());
-
-  xmlNodePtr time_container_node =
-      xmlNewChild(desc_container_node, nullptr, BAD_CAST "time", nullptr);
-
-  xmlNewTextChild(time_container_node, nullptr, BAD_CAST "start",
-                  BAD_CAST base::NumberToString(0).c_str());
-
-  const base::TimeDelta end_time = base::TimeTicks::Now() - start_;
-  xmlNewTextChild(
-      time_container_node, nullptr, BAD_CAST "end",
-      BAD_CAST base::NumberToString(end_time.InMilliseconds()).c_str());
-
-  for (const auto& graphml_attr : brave_page_graph::GetGraphMLAttrs()) {
-    graphml_attr.second->AddDefinitionNode(graphml_root_node);
+  // Chunks end between items, so each holds whole UTF-8 sequences and is
+  // converted on its own, rather than the whole document being held as UTF-8
+  // and then converted.
+  GraphMLExporter exporter(this);
+  StringBuilder graphml_builder;
+  std::string chunk;
+  bool has_more_chunks = true;
+  while (has_more_chunks) {
+    chunk.clear();
+    has_more_chunks = exporter.WriteNextChunk(kGraphMLChunkSize, &chunk);
+    const String chunk_string = String::FromUTF8(chunk.data(), chunk.size());
+    if (chunk_string.IsNull()) {
+      // Bytes which aren't valid UTF-8 end up in the output as they are, the
+      // same as with libxml2, and the document can't be converted.
+      return String();
+    }
+    graphml_builder.Append(chunk_string);
   }
+  auto graphml_string = graphml_builder.ToString();
+  DCHECK(!graphml_string.empty());
+  return graphml_string;
+}
+
+PageGraph::GraphMLExporter::GraphMLExporter(const PageGraph* page_graph)
+    : page_graph_(page_graph),
+      writer_(nullptr),
+      node_count_(page_graph->nodes_.size()),
+      edge_count_(page_graph->edges_.size()) {}
 
-  xmlNodePtr graph_node =
-      xmlNewChild(graphml_root_node, nullptr, BAD_CAST "graph", nullptr);
-  xmlSetProp(graph_node, BAD_CAST "id", BAD_CAST "G");
-  xmlSetProp(graph_node, BAD_CAST "edgedefault", BAD_CAST "directed");
+PageGraph::GraphMLExporter::~GraphMLExporter() = default;
 
-  for (const auto* node : nodes_) {
-    node->AddGraphMLTag(graphml_doc, graph_node);
+bool PageGraph::GraphMLExporter::WriteNextChunk(size_t chunk_size,
+                                                std::string* output) {
+  if (finished_) {
+    return false;
   }
-  for (const auto* edge : edges_) {
-    edge->AddGraphMLTag(graphml_doc, graph_node);
+  writer_.set_output(output);
+  const size_t chunk_end = output->size() + chunk_size;
+
+  if (!started_) {
+    WriteHeader();
+    started_ = true;
+  }
+  // Nodes and edges are written out in the order they were added, nodes
+  // first, the same as when the whole document was built at once.
+  while (next_node_ < node_count_ && output->size() < chunk_end) {
+    page_graph_->nodes_[next_node_++]->AddGraphMLTag(&writer_);
+  }
+  while (next_node_ == node_count_ && next_edge_ < edge_count_ &&
+         output->size() < chunk_end) {
+    page_graph_->edges_[next_edge_++]->AddGraphMLTag(&writer_);
+  }
+  if (next_node_ < node_count_ || next_edge_ < edge_count_) {
+    return true;
   }
 
-  xmlChar* xml_string;
-  int size;
-  xmlDocDumpMemoryEnc(graphml_doc, &xml_string, &size, "UTF-8");
-  auto graphml_string = String::FromUTF8(xml_string, size);
-  DCHECK(!graphml_string.empty());
+  writer_.EndDocument();
+  finished_ = true;
+  return false;
+}
 
-  xmlFree(xml_string);
-  xmlFree(graphml_doc);
+void PageGraph::GraphMLExporter::WriteHeader() {
+  writer_.StartDocument();
+  writer_.StartElement("graphml");
+  writer_.AddAttribute("xmlns", "http://graphml.graphdrawing.org/xmlns");
+  writer_.AddAttribute("xmlns:xsi",
+                       "http://www.w3.org/2001/XMLSchema-instance");
+  writer_.AddAttribute("xsi:schemaLocation",
+                       "http://graphml.graphdrawing.org/xmlns "
+                       "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd");
 
-  return graphml_string;
+  writer_.StartElement("desc");
+  writer_.AddTextElement("version", kPageGraphVersion);
+  writer_.AddTextElement("about", kPageGraphUrl);
+  writer_.AddTextElement("is_root",
+                         page_graph_->IsRootFrame() ? "true" : "false");
+  writer_.AddTextElement("frame_id", page_graph_->frame_id_);
+
+  writer_.StartElement("time");
+  writer_.AddTextElement("start", base::NumberToString(0));
+  const base::TimeDelta end_time =
+      base::TimeTicks::Now() - page_graph_->start_;
+  writer_.AddTextElement("end",
+                         base::NumberToString(end_time.InMilliseconds()));
+  writer_.EndElement();
+  writer_.EndElement();
+
+  for (const auto& graphml_attr : brave_page_graph::GetGraphMLAttrs()) {
+    graphml_attr.second->AddDefinitionNode(&writer_);
+  }
+
+  writer_.StartElement("graph");
+  writer_.AddAttribute("id", "G");
+  writer_.AddAttribute("edgedefault", "directed");
 }
 
 NodeHTML* PageGraph::GetHTMLNode(const DOMNodeId node_id) const {
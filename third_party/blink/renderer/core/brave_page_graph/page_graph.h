@@ -13,6 +13,7 @@
 
 #include "base/time/time.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/blink_probe_types.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graphml.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/page_graph_context.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/requests/request_tracker.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/scripts/script_tracker.h"
@@ -27,6 +28,7 @@
 #include "third_party/blink/renderer/core/inspector/protocol/protocol.h"
 #include "third_party/blink/renderer/platform/heap/garbage_collected.h"
 #include "third_party/blink/renderer/platform/heap/member.h"
+#include "third_party/blink/renderer/platform/heap/persistent.h"
 #include "third_party/blink/renderer/platform/supplementable.h"
 #include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
 
@@ -229,6 +231,37 @@ class CORE_EXPORT PageGraph : public GarbageCollected<PageGraph>,
                              blink::protocol::Array<String>& report);
   String ToGraphML() const;
 
+  // Writes the graph out as GraphML a chunk at a time, so that callers can
+  // yield between chunks. Only the nodes and edges which are in the graph when
+  // the export starts are written out, but each is written as it is when its
+  // chunk is: an element's structure and event listener edges follow its
+  // children and listeners at that point. Callers which let the page run
+  // between chunks don't get a consistent snapshot of the DOM.
+  class CORE_EXPORT GraphMLExporter {
+   public:
+    explicit GraphMLExporter(const PageGraph* page_graph);
+    GraphMLExporter(const GraphMLExporter&) = delete;
+    GraphMLExporter& operator=(const GraphMLExporter&) = delete;
+    ~GraphMLExporter();
+
+    // Appends about |chunk_size| bytes of GraphML to |output|, more if a
+    // single node or edge doesn't fit. Returns false once the end of the
+    // document has been written.
+    bool WriteNextChunk(size_t chunk_size, std::string* output);
+
+   private:
+    void WriteHeader();
+
+    Persistent<const PageGraph> page_graph_;
+    brave_page_graph::GraphMLWriter writer_;
+    const size_t node_count_;
+    const size_t edge_count_;
+    size_t next_node_ = 0;
+    size_t next_edge_ = 0;
+    bool started_ = false;
+    bool finished_ = false;
+  };
+
  private:
 #define PAGE_GRAPH_USING_DECL(type) using type = brave_page_graph::type
   PAGE_GRAPH_USING_DECL(Binding);
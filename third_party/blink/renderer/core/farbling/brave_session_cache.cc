@@ -11,6 +11,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/types/optional_util.h"
 #include "brave/third_party/blink/renderer/brave_farbling_constants.h"
+#include "brave/third_party/blink/renderer/brave_farbling_hash.h"
 #include "brave/third_party/blink/renderer/brave_font_whitelist.h"
 #include "build/build_config.h"
 #include "crypto/hmac.h"
@@ -276,8 +277,19 @@ void BraveSessionCache::PerturbPixelsInternal(const unsigned char* data,
   CHECK(h.Init(reinterpret_cast<const unsigned char*>(&session_plus_domain_key),
                sizeof session_plus_domain_key));
   uint8_t canvas_key[32];
-  CHECK(h.Sign(base::StringPiece(reinterpret_cast<const char*>(pixels), size),
-               canvas_key, sizeof canvas_key));
+  if (base::FeatureList::IsEnabled(
+          blink::features::kBraveFastCanvasFarbling)) {
+    // Only a digest of the pixels goes through HMAC. The digest is keyed on
+    // the domain key, so it already differs per session and domain.
+    uint8_t digest[kFarblingHashSize];
+    FarblingHash(domain_key_, pixels, size, digest);
+    CHECK(h.Sign(base::StringPiece(reinterpret_cast<const char*>(digest),
+                                   sizeof digest),
+                 canvas_key, sizeof canvas_key));
+  } else {
+    CHECK(h.Sign(base::StringPiece(reinterpret_cast<const char*>(pixels), size),
+                 canvas_key, sizeof canvas_key));
+  }
   uint64_t v = *reinterpret_cast<uint64_t*>(canvas_key);
   uint64_t pixel_index;
   // choose which channel (R, G, or B) to perturb